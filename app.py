@@ -1,14 +1,12 @@
-from flask import Flask, render_template, request, redirect, url_for, session
-import math
-import matplotlib.pyplot as plt
-import matplotlib.patches as mpatches
-import io
-import base64
+import os
+from flask import Flask, jsonify, render_template, request, redirect, url_for, session
+from calendar_cache import CalendarCache, calendar_key
+from scheduler_lib import DAYS, FREQUENCIES, SLOT_MINUTES, Scheduler, render_month
 
 app = Flask(__name__)
 app.secret_key = 'your_secret_key'  # Change this!
 
-# Default durations for each meeting type (still used for other purposes if needed)
+# Default durations for each meeting type; the scheduler rounds them up to whole slots
 DEFAULT_DURATIONS = {
     "One-to-One Meeting": 30,
     "All-Hands Meeting": 60,
@@ -39,18 +37,25 @@ TEXT_COLORS = {
     "darkorange": "black",
 }
 
-# Recurrence options delta values (in days)
-# Monthly meetings occur only once.
-RECURRENCE_DELTA = {
-    "Weekly": 7,
-    "Fortnightly": 14,
-    "Every Third Week": 21,
-    "Monthly": None,
-}
+# Planning horizon handed to the native scheduler: four Mon–Fri weeks
+CALENDAR_WEEKS = 4
+CALENDAR_DAYS = 5
+
+# Free slots offered while the request form is being filled in
+SUGGESTION_COUNT = 5
 
 # Fixed visual height for each meeting bar (in minutes, relative to the 9:00–5:00 = 480 minute day)
 FIXED_BAR_DURATION = 30  # All bars are drawn with the height equivalent to 30 minutes
 
+# Computed calendars, shared by all workers through one SQLite file and keyed by
+# the meeting list, so a repeated view of an unchanged list does no work
+CALENDAR_CACHE = CalendarCache(os.environ.get("CALENDAR_CACHE_PATH"),
+                               int(os.environ.get("CALENDAR_CACHE_SIZE", "256")))
+
+def meetings_key(meetings):
+    """Cache key of a meeting list under the current calendar settings."""
+    return calendar_key(meetings, CALENDAR_WEEKS, CALENDAR_DAYS, FIXED_BAR_DURATION, SLOT_MINUTES)
+
 @app.route('/', methods=['GET', 'POST'])
 def add_meeting():
     """
@@ -71,8 +76,8 @@ def add_meeting():
         preferred_day = request.form.get("preferred_day")
         person_name = request.form.get("person_name")
         
-        # Do not proceed if meeting type is not chosen.
-        if not meeting_type:
+        # Do not proceed if meeting type is not chosen, or the recurrence is not one the scheduler knows.
+        if not meeting_type or (recurrence and recurrence not in FREQUENCIES):
             return redirect(url_for('add_meeting'))
         
         # Generate an order based on submission order
@@ -89,177 +94,143 @@ def add_meeting():
         }
         meetings.append(meeting)
         session['meetings'] = meetings
+        session['calendar_key'] = meetings_key(meetings)
         return redirect(url_for('add_meeting'))
     return render_template("add_meeting.html", meetings=session.get('meetings', []))
 
+def format_time(minutes):
+    """Formats minutes after midnight as a 12-hour clock time."""
+    hour, minute = divmod(int(minutes), 60)
+    suffix = "AM" if hour < 12 else "PM"
+    display_hour = hour if hour <= 12 else hour - 12
+    if display_hour == 0:
+        display_hour = 12
+    return f"{display_hour}:{minute:02d} {suffix}"
+
 @app.route('/calendar')
 def calendar_view():
     """
-    Generates the monthly schedule as an image.
-    
-    • Meetings are scheduled only on weekdays (Mon–Fri); weekends are grayed out.
-    • For each meeting request, if a Preferred Day is provided, the scheduler picks the earliest instance of that weekday in the month.
-      Otherwise, it uses load-balancing (with Fridays slightly penalized).
-    • Recurring meetings are scheduled by adding 7, 14, or 21 days, keeping the same weekday.
-    • In each day cell, meetings in the Morning (9:00–12:00) or Afternoon (12:00–5:00)
-      are assigned a discrete start time (only on the hour or half‑hour) from a fixed list.
+    Generates the monthly schedule as an SVG image, drawn by the native renderer.
+
+    • Placement is done by the native scheduler (libscheduler.so via scheduler_lib) over a
+      four-week month of Mon–Fri days; weekends are grayed out.
+    • A Preferred Day fixes the weekday; otherwise the least loaded day is used, with at most
+      2.5 hours of meetings per day and week.
+    • Every occurrence of a series keeps the same weekday and start time; a series gets 4, 2,
+      1 or 1 occurrences for Weekly, Fortnightly, Every Third Week and Monthly.
+    • Morning meetings start from 9:00–11:30 and Afternoon meetings from 1:00–4:30, on the
+      hour or half hour. Meetings that do not fit are listed under the calendar.
+    • Durations are rounded up to whole 30-minute slots, so a 20- or 45-minute meeting takes
+      30 or 60 minutes of the day and counts that much toward the daily cap and balancing.
     • Every meeting is drawn with a constant fixed height and its label shows the meeting’s start time.
     """
-    meeting_requests = session.get('meetings', [])
-    
-    # Helper: in our generic month, day 1 is Monday.
-    def is_weekday(day):
-        return (day - 1) % 7 < 5
+    calendar = session_calendar()
+    return render_template("calendar_result.html", calendar_svg=calendar["calendar_svg"],
+                           unplaced=calendar["unplaced"])
 
-    def is_friday(day):
-        return (day - 1) % 7 == 4
+MORNING_SLOTS = [s for s, minutes in enumerate(SLOT_MINUTES) if minutes < 12 * 60]
+AFTERNOON_SLOTS = [s for s, minutes in enumerate(SLOT_MINUTES) if minutes >= 12 * 60]
 
-    # List available weekdays
-    available_days = [day for day in range(1, 32) if is_weekday(day)]
-    day_events = {day: [] for day in available_days}
-    day_workload = {day: 0 for day in available_days}
-    
-    # Process each meeting request.
-    for meeting in meeting_requests:
-        rec = meeting["recurrence"]
-        delta = RECURRENCE_DELTA.get(rec)
-        preferred = meeting.get("preferred_day")
-        # If a preferred day is provided, choose the earliest instance of that weekday.
-        if preferred:
-            mapping = {"Monday": 0, "Tuesday": 1, "Wednesday": 2, "Thursday": 3, "Friday": 4}
-            target = mapping.get(preferred)
-            filtered = [d for d in available_days if (d - 1) % 7 == target]
-            if filtered:
-                base_day = min(filtered)  # Earliest instance on that day
-            else:
-                base_day = min(available_days)
-        else:
-            base_day = min(available_days, key=lambda d: ((1 if is_friday(d) else 0), day_workload[d]))
-        
-        occurrences = []
-        if delta is None:
-            # Monthly: one occurrence.
-            if base_day <= 31:
-                occurrences.append(base_day)
-                day_workload[base_day] += 1
-        else:
-            occ = 0
-            candidate_day = base_day + occ * delta
-            while candidate_day <= 31:
-                if is_weekday(candidate_day):
-                    occurrences.append(candidate_day)
-                    day_workload[candidate_day] += 1
-                occ += 1
-                candidate_day = base_day + occ * delta
-        
-        # For each occurrence, create an event.
-        for occ_day in occurrences:
-            mt = meeting["meeting_type"]
-            ts = meeting["time_slot"]
-            pname = meeting.get("person_name", "")
-            base_text = f"1:1 with {pname}" if mt == "One-to-One Meeting" else mt
-            ev = {
-                "meeting_type": mt,
-                "time_slot": ts,
-                "base_text": base_text,
-                "color": MEETING_COLORS.get(mt, "black"),
-                "start": None,  # Will be assigned below.
-                "order": meeting.get("order", 0)  # Use provided order, fallback to 0 if missing
-            }
-            day_events[occ_day].append(ev)
-    
-    # Define fixed valid start times (in minutes from 9:00 AM) for each slot.
-    morning_valid = [0, 30, 60, 90, 120, 150]      # 9:00, 9:30, ... 11:30
-    afternoon_valid = list(range(180, 451, 30))       # 12:00 to 4:30 (last start so that the bar fits before 5:00)
+def session_calendar():
+    """The computed calendar of the session's meetings, from the cache when possible."""
+    # The key changes only when add_meeting or /clear changes the list
+    key = session.get('calendar_key')
+    if key is None:
+        key = session['calendar_key'] = meetings_key(session.get('meetings', []))
+    calendar = CALENDAR_CACHE.get(key)
+    # Entries cached before placements were kept are computed again
+    if calendar is None or "placed" not in calendar:
+        calendar = compute_calendar(session.get('meetings', []))
+        CALENDAR_CACHE.put(key, calendar)
+    return calendar
+
+def placement_request(meeting):
+    """Scheduler.add_all() arguments for a stored meeting request."""
+    mt = meeting["meeting_type"]
+    preferred = meeting.get("preferred_day")
+    pname = meeting.get("person_name", "")
+    return {"name": f"1:1 with {pname}" if mt == "One-to-One Meeting" else mt, "meeting_type": mt,
+            "duration_minutes": DEFAULT_DURATIONS.get(mt, 30),
+            "frequency": meeting.get("recurrence") or "Weekly",
+            "day": DAYS.index(preferred) if preferred in DAYS[:CALENDAR_DAYS] else None,
+            "preferred": MORNING_SLOTS if meeting.get("time_slot") == "Morning" else AFTERNOON_SLOTS}
 
-    # For each day, assign start times for each meeting, ensuring consistent ordering.
-    for day, events in day_events.items():
-        groups = {"Morning": [], "Afternoon": []}
-        for ev in events:
-            groups[ev["time_slot"]].append(ev)
-        for slot, ev_list in groups.items():
-            if not ev_list:
-                continue
-            valid_slots = morning_valid if slot == "Morning" else afternoon_valid
-            n = len(ev_list)
-            m = len(valid_slots)
-            if n == 1:
-                ev_list[0]["start"] = valid_slots[m // 2]
+def compute_calendar(meetings):
+    """
+    Places the meetings and draws the month; returns the events, unplaced meetings and SVG,
+    plus where each series went as Scheduler.place() arguments.
+    """
+    meeting_requests = sorted(meetings, key=lambda m: m.get("order", 0))
+
+    events = []
+    unplaced = []
+    placed = []
+    with Scheduler(CALENDAR_WEEKS, CALENDAR_DAYS) as scheduler:
+        # The whole set is placed together, least flexible first, so a late
+        # fixed-day request is not crowded out by earlier flexible ones.
+        batch = [placement_request(meeting) for meeting in meeting_requests]
+        labels = {}
+        series_list = scheduler.add_all(batch)
+        for request_args, series in zip(batch, series_list):
+            if series is None:
+                unplaced.append(request_args["name"])
             else:
-                # Sort events by their permanent order so that repeated meetings get the same slot each week.
-                sorted_events = sorted(ev_list, key=lambda e: e.get("order", 0))
-                for i, ev in enumerate(sorted_events):
-                    index = round(i * (m - 1) / (n - 1))
-                    ev["start"] = valid_slots[index]
-    
-    # Create a generic 31-day grid. (7 columns: Mon–Sun; weekends are grayed out.)
-    total_days = 31
-    cols = 7
-    rows = math.ceil(total_days / cols)
-    
-    fig, ax = plt.subplots(figsize=(16, 12))
-    ax.set_title("Optimized 31-Day Project Calendar (Meetings: Mon–Fri)", fontsize=16, pad=20)
-    
-    # Helper: format meeting time from minutes after 9:00 AM.
-    def format_time(minutes_after_9):
-        total = int(9 * 60 + minutes_after_9)
-        hour = total // 60
-        minute = total % 60
-        suffix = "AM" if hour < 12 else "PM"
-        display_hour = hour if hour <= 12 else hour - 12
-        if display_hour == 0:
-            display_hour = 12
-        return f"{display_hour}:{minute:02d} {suffix}"
-    
-    # Draw the calendar cells.
-    for day in range(1, total_days + 1):
-        idx = day - 1
-        row_idx = idx // cols
-        col_idx = idx % cols
-        cell_x = col_idx - 0.5
-        cell_y = row_idx - 0.5
-        cell_color = "lightgrey" if col_idx in [5, 6] else "white"
-        ax.add_patch(mpatches.Rectangle((cell_x, cell_y), 1, 1,
-                                        facecolor=cell_color, edgecolor="black"))
-        ax.text(cell_x + 0.05, cell_y + 0.95, str(day),
-                ha="left", va="top", fontsize=10, weight="bold")
-        
-        # Draw meeting events for this day.
-        if day in day_events:
-            for ev in day_events[day]:
-                bar_height = FIXED_BAR_DURATION / 480.0  # Fixed height across all bars.
-                global_x = cell_x  # Bar spans the full width.
-                global_y = cell_y + ev["start"] / 480.0
-                meeting_time_str = format_time(ev["start"])
-                full_text = f"{ev['base_text']} @ {meeting_time_str}"
-                ax.add_patch(mpatches.Rectangle((global_x, global_y), 1, bar_height,
-                                                facecolor=ev["color"], edgecolor="black", lw=0.5))
-                ax.text(global_x + 0.5, global_y + bar_height / 2,
-                        full_text,
-                        ha="center", va="center", fontsize=8,
-                        color=TEXT_COLORS.get(ev["color"], "white"))
-    
-    ax.set_xticks(range(cols))
-    ax.set_xticklabels(["Mon", "Tue", "Wed", "Thu", "Fri", "Sat", "Sun"], fontsize=12)
-    ax.set_yticks(range(rows))
-    ax.set_yticklabels([f"Week {i+1}" for i in range(rows)], fontsize=12)
-    ax.set_xlim(-0.5, cols - 0.5)
-    ax.set_ylim(-0.5, rows - 0.5)
-    ax.invert_yaxis()
-    ax.grid(True, which="both", linestyle="--", linewidth=0.5)
-    
-    plt.tight_layout()
-    buf = io.BytesIO()
-    plt.savefig(buf, format="png", dpi=150, bbox_inches="tight")
-    buf.seek(0)
-    image_base64 = base64.b64encode(buf.getvalue()).decode('utf-8')
-    plt.close(fig)
-    return render_template("calendar_result.html", image_base64=image_base64)
+                labels[series] = (request_args["name"], MEETING_COLORS.get(request_args["meeting_type"], "black"))
+
+        # In our generic month, day 1 is Monday of week 1.
+        first = {}
+        for occ in scheduler.occurrences():
+            base_text, color = labels[occ.series]
+            first.setdefault(occ.series, occ)
+            events.append((occ.week * 7 + occ.day, occ.start_minutes, occ.duration_minutes, color,
+                           TEXT_COLORS.get(color, "white"), f"{base_text} @ {format_time(occ.start_minutes)}"))
+
+    for request_args, series in zip(batch, series_list):
+        if series is not None:
+            occ = first[series]
+            placed.append({"name": request_args["name"], "meeting_type": request_args["meeting_type"],
+                           "duration_minutes": request_args["duration_minutes"],
+                           "frequency": request_args["frequency"], "day": occ.day,
+                           "slot": SLOT_MINUTES.index(occ.start_minutes), "first_week": occ.week})
+
+    # The month grid has 7 columns (Mon–Sun); weekends are grayed out.
+    total_days = CALENDAR_WEEKS * 7
+    cells = [(day, "lightgrey" if (day - 1) % 7 >= 5 else "white", None) for day in range(1, total_days + 1)]
+    calendar_svg = render_month(f"Optimized {total_days}-Day Project Calendar (Meetings: Mon–Fri)",
+                                CALENDAR_WEEKS, cells, events, bar_minutes=FIXED_BAR_DURATION)
+    return {"events": events, "unplaced": unplaced, "placed": placed, "calendar_svg": calendar_svg}
+
+@app.route('/suggest')
+def suggest_slots():
+    """
+    Live suggestions for the request form, called as its fields change: the free
+    slots the meeting described by the query string could take next to the
+    meetings already requested, best balanced first. The requested meetings are
+    put back where the cached calendar placed them, so only the search for free
+    slots runs here. Nothing is stored.
+    """
+    meeting = {field: request.args.get(field) for field in
+               ("meeting_type", "time_slot", "recurrence", "preferred_day", "person_name")}
+    if not meeting["meeting_type"]:
+        return jsonify(suggestions=[])
+    proposed = placement_request(meeting)
+    if proposed["frequency"] not in FREQUENCIES:
+        return jsonify(error=f"Unknown recurrence: {proposed['frequency']}"), 400
+    placed = session_calendar()["placed"]
+    with Scheduler(CALENDAR_WEEKS, CALENDAR_DAYS) as scheduler:
+        for series in placed:
+            scheduler.place(**series)
+        slots = scheduler.free_slots(proposed["duration_minutes"], proposed["frequency"], day=proposed["day"],
+                                     preferred=proposed["preferred"], limit=SUGGESTION_COUNT)
+    return jsonify(suggestions=[{"day": DAYS[slot.day], "time": format_time(slot.start_minutes),
+                                 "first_week": slot.first_week + 1, "occurrences": slot.occurrences}
+                                for slot in slots])
 
 @app.route('/clear')
 def clear_meetings():
     """Clear all stored meeting requests."""
     session.pop('meetings', None)
+    session.pop('calendar_key', None)
     return redirect(url_for('add_meeting'))
 
 if __name__ == '__main__':
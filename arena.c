@@ -0,0 +1,126 @@
+#include <stdlib.h>
+#include <string.h>
+#include "arena.h"
+
+#define ARENA_ALIGN 16
+
+static ArenaBlock *new_block(size_t size) {
+    ArenaBlock *block = malloc(sizeof(ArenaBlock) + size);
+    if (!block) return NULL;
+    block->next = NULL;
+    block->size = size;
+    block->used = 0;
+    return block;
+}
+
+void arena_init(Arena *arena, size_t block_size) {
+    arena->head = NULL;
+    arena->current = NULL;
+    arena->block_size = block_size;
+    arena->failed = false;
+}
+
+void *arena_alloc(Arena *arena, size_t size) {
+    size = (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+    ArenaBlock *block = arena->current;
+    // Walk forward through blocks retained by a previous reset before growing
+    while (block && block->used + size > block->size) {
+        if (!block->next) break;
+        block = block->next;
+        block->used = 0;
+    }
+    if (!block || block->used + size > block->size) {
+        ArenaBlock *fresh = new_block(size > arena->block_size ? size : arena->block_size);
+        if (!fresh) {
+            arena->failed = true;
+            return NULL;
+        }
+        if (block) {
+            fresh->next = block->next;
+            block->next = fresh;
+        } else {
+            arena->head = fresh;
+        }
+        block = fresh;
+    }
+    arena->current = block;
+    void *ptr = block->data + block->used;
+    block->used += size;
+    return ptr;
+}
+
+void *arena_calloc(Arena *arena, size_t size) {
+    void *ptr = arena_alloc(arena, size);
+    if (ptr) memset(ptr, 0, size);
+    return ptr;
+}
+
+// Drop every allocation but keep the blocks for reuse
+void arena_reset(Arena *arena) {
+    arena->current = arena->head;
+    if (arena->head) arena->head->used = 0;
+}
+
+void arena_free(Arena *arena) {
+    ArenaBlock *block = arena->head;
+    while (block) {
+        ArenaBlock *next = block->next;
+        free(block);
+        block = next;
+    }
+    arena->head = NULL;
+    arena->current = NULL;
+}
+
+void store_init(Store *store, Arena *arena, size_t elem_size) {
+    store->arena = arena;
+    store->elem_size = elem_size;
+    store->chunks = NULL;
+    store->chunk_count = 0;
+    store->chunk_capacity = 0;
+    store->count = 0;
+}
+
+void *store_push(Store *store) {
+    if ((store->count >> STORE_CHUNK_SHIFT) == store->chunk_count) {
+        if (store->chunk_count == store->chunk_capacity) {
+            // The old directory stays in the arena; doubling keeps the waste bounded
+            int capacity = store->chunk_capacity ? store->chunk_capacity * 2 : 8;
+            unsigned char **chunks = arena_alloc(store->arena, capacity * sizeof(*chunks));
+            if (!chunks) return NULL;
+            if (store->chunk_count) memcpy(chunks, store->chunks, store->chunk_count * sizeof(*chunks));
+            store->chunks = chunks;
+            store->chunk_capacity = capacity;
+        }
+        unsigned char *chunk = arena_alloc(store->arena, STORE_CHUNK_SIZE * store->elem_size);
+        if (!chunk) return NULL;
+        store->chunks[store->chunk_count++] = chunk;
+    }
+    return store_at(store, store->count++);
+}
+
+// Views `count` contiguous elements at `base` as a store without copying. A
+// partly filled last chunk is copied into the arena so later pushes never
+// write past the end of the caller's array. False when out of memory.
+bool store_map(Store *store, Arena *arena, size_t elem_size, void *base, int count) {
+    store_init(store, arena, elem_size);
+    int chunk_count = (count + STORE_CHUNK_SIZE - 1) >> STORE_CHUNK_SHIFT;
+    int capacity = 8;
+    while (capacity < chunk_count) capacity *= 2;
+    store->chunks = arena_alloc(arena, capacity * sizeof(*store->chunks));
+    if (!store->chunks) return false;
+    store->chunk_capacity = capacity;
+    for (int k = 0; k < chunk_count; k++) {
+        store->chunks[k] = (unsigned char *)base + (size_t)k * STORE_CHUNK_SIZE * elem_size;
+    }
+    int tail = count & (STORE_CHUNK_SIZE - 1);
+    if (tail) {
+        unsigned char *chunk = arena_alloc(arena, STORE_CHUNK_SIZE * elem_size);
+        if (!chunk) return false;
+        memcpy(chunk, store->chunks[chunk_count - 1], (size_t)tail * elem_size);
+        store->chunks[chunk_count - 1] = chunk;
+    }
+    store->chunk_count = chunk_count;
+    store->count = count;
+    return true;
+}
@@ -0,0 +1,58 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Bump allocator: memory is handed out from large blocks and released all at
+// once. When a block cannot be had, allocation returns NULL and sets `failed`,
+// which stays set until the owner clears it.
+typedef struct ArenaBlock {
+    struct ArenaBlock *next;
+    size_t size;
+    size_t used;
+    unsigned char data[];
+} ArenaBlock;
+
+typedef struct {
+    ArenaBlock *head; // First block; blocks are kept across resets
+    ArenaBlock *current; // Block currently being filled
+    size_t block_size;
+    bool failed; // An allocation could not be met
+} Arena;
+
+void arena_init(Arena *arena, size_t block_size);
+void *arena_alloc(Arena *arena, size_t size);
+void *arena_calloc(Arena *arena, size_t size);
+void arena_reset(Arena *arena);
+void arena_free(Arena *arena);
+
+// Growable array of fixed-size elements, stored in arena chunks so element
+// addresses stay stable as it grows
+#define STORE_CHUNK_SHIFT 10
+#define STORE_CHUNK_SIZE (1 << STORE_CHUNK_SHIFT)
+
+typedef struct {
+    Arena *arena;
+    size_t elem_size;
+    unsigned char **chunks;
+    int chunk_count;
+    int chunk_capacity;
+    int count;
+} Store;
+
+void store_init(Store *store, Arena *arena, size_t elem_size);
+// Room for one more element, or NULL when out of memory
+void *store_push(Store *store);
+bool store_map(Store *store, Arena *arena, size_t elem_size, void *base, int count);
+
+// Drops elements from the end, e.g. to undo pushes a failed allocation cut short
+static inline void store_truncate(Store *store, int count) {
+    if (count < store->count) store->count = count;
+}
+
+static inline void *store_at(const Store *store, int i) {
+    return store->chunks[i >> STORE_CHUNK_SHIFT] + (size_t)(i & (STORE_CHUNK_SIZE - 1)) * store->elem_size;
+}
+
+#endif
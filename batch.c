@@ -0,0 +1,513 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "batch.h"
+
+#define BATCH_IO_BUFFER (1 << 20)
+#define MAX_CSV_COLUMNS 16
+#define MAX_ATTENDEES 1024
+
+// One parsed input record; reused for every line so parsing never allocates
+typedef struct {
+    int kind; // -1 unknown, 0 reservation, 1 meeting, 2 remove, 3 move
+    Meeting meeting;
+    int attendees[MAX_ATTENDEES]; // Backs meeting.attendees once the record is accepted
+    const char *attendee_names[MAX_ATTENDEES]; // Point into the input line
+    char attendee[MAX_STR]; // Whose calendar a reservation blocks; empty for the organiser
+    int preferred_count;
+    char day[MAX_STR];
+    char start[MAX_STR];
+    int duration_minutes;
+    const char *error;
+} BatchRecord;
+
+static void reset_record(BatchRecord *rec) {
+    memset(&rec->meeting, 0, sizeof(rec->meeting));
+    for (int i = 0; i < 8; i++) rec->meeting.preferred_hours[i] = -1;
+    rec->meeting.attendees = rec->attendees;
+    rec->kind = -1;
+    rec->attendee[0] = '\0';
+    rec->preferred_count = 0;
+    rec->day[0] = '\0';
+    rec->start[0] = '\0';
+    rec->duration_minutes = 0;
+    rec->error = NULL;
+}
+
+static bool copy_field(BatchRecord *rec, char *dest, const char *value) {
+    size_t len = strlen(value);
+    if (len >= MAX_STR) {
+        rec->error = "field too long";
+        return false;
+    }
+    memcpy(dest, value, len + 1);
+    return true;
+}
+
+static bool add_preferred(BatchRecord *rec, const char *value) {
+    if (!*value) return true;
+    int slot = isdigit((unsigned char)value[0]) && !strchr(value, ':') ? atoi(value) : find_slot_index(value);
+    if (slot < 0 || slot >= slot_count()) {
+        rec->error = "unknown preferred time";
+        return false;
+    }
+    if (rec->preferred_count >= 7) {
+        rec->error = "too many preferred times";
+        return false;
+    }
+    rec->meeting.preferred_hours[rec->preferred_count++] = slot;
+    rec->meeting.preferred_hours[rec->preferred_count] = -1;
+    return true;
+}
+
+// Space-separated list, as used by CSV and by the interactive menu
+static bool add_preferred_list(BatchRecord *rec, char *value) {
+    char *save = NULL;
+    for (char *token = strtok_r(value, " ", &save); token; token = strtok_r(NULL, " ", &save)) {
+        if (!add_preferred(rec, token)) return false;
+    }
+    return true;
+}
+
+static bool add_attendee(BatchRecord *rec, const char *name) {
+    if (!*name) return true;
+    if (rec->meeting.attendee_count >= MAX_ATTENDEES) {
+        rec->error = "too many attendees";
+        return false;
+    }
+    rec->attendee_names[rec->meeting.attendee_count++] = name;
+    return true;
+}
+
+// Names become people only once the record is valid; apply_record, or the
+// caller after placing a collected set, drops those left attending nothing
+static bool register_attendees(MeetingScheduler *scheduler, BatchRecord *rec) {
+    for (int i = 0; i < rec->meeting.attendee_count; i++) {
+        rec->attendees[i] = add_person(scheduler, rec->attendee_names[i]);
+        if (rec->attendees[i] < 0) {
+            rec->error = "out of memory";
+            return false;
+        }
+    }
+    return true;
+}
+
+// Semicolon-separated names, since names may contain spaces
+static bool add_attendee_list(BatchRecord *rec, char *value) {
+    char *save = NULL;
+    for (char *token = strtok_r(value, ";", &save); token; token = strtok_r(NULL, ";", &save)) {
+        while (*token == ' ') token++;
+        if (!add_attendee(rec, token)) return false;
+    }
+    return true;
+}
+
+static bool set_field(BatchRecord *rec, const char *key, char *value) {
+    if (strcmp(key, "kind") == 0) {
+        if (strcmp(value, "meeting") == 0) rec->kind = 1;
+        else if (strcmp(value, "reservation") == 0) rec->kind = 0;
+        else if (strcmp(value, "remove") == 0) rec->kind = 2;
+        else if (strcmp(value, "move") == 0) rec->kind = 3;
+        else if (*value) {
+            rec->error = "unknown kind";
+            return false;
+        }
+        return true;
+    }
+    if (strcmp(key, "name") == 0) return copy_field(rec, rec->meeting.name, value);
+    if (strcmp(key, "type") == 0) return copy_field(rec, rec->meeting.type, value);
+    if (strcmp(key, "frequency") == 0) {
+        int frequency = *value ? parse_frequency(value) : FREQ_WEEKLY;
+        if (frequency < 0) {
+            rec->error = "unknown frequency";
+            return false;
+        }
+        rec->meeting.frequency = frequency;
+        return true;
+    }
+    if (strcmp(key, "fixed_day") == 0) return copy_field(rec, rec->meeting.fixed_day, value);
+    if (strcmp(key, "fixed_time") == 0) return copy_field(rec, rec->meeting.fixed_time, value);
+    if (strcmp(key, "day") == 0) return copy_field(rec, rec->day, value);
+    if (strcmp(key, "start") == 0) return copy_field(rec, rec->start, value);
+    if (strcmp(key, "duration") == 0) {
+        char *end;
+        long minutes = strtol(value, &end, 10);
+        if (end == value || *end) {
+            rec->error = "duration is not a number";
+            return false;
+        }
+        rec->duration_minutes = (int)minutes;
+        return true;
+    }
+    if (strcmp(key, "preferred") == 0) return add_preferred_list(rec, value);
+    if (strcmp(key, "attendees") == 0) return add_attendee_list(rec, value);
+    if (strcmp(key, "attendee") == 0) return copy_field(rec, rec->attendee, value);
+    return true; // Unknown fields are ignored so producers can add metadata
+}
+
+// --------------------
+// JSONL records
+// --------------------
+
+static char *skip_space(char *p) {
+    while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') p++;
+    return p;
+}
+
+// Decodes a JSON string in place; *p points at the opening quote
+static char *parse_string(char **p) {
+    char *src = *p + 1;
+    char *out = src;
+    char *dst = src;
+    while (*src && *src != '"') {
+        if (*src == '\\') {
+            src++;
+            switch (*src) {
+                case 'n': *dst++ = '\n'; break;
+                case 't': *dst++ = '\t'; break;
+                case 'r': *dst++ = '\r'; break;
+                case 'b': *dst++ = '\b'; break;
+                case 'f': *dst++ = '\f'; break;
+                case 'u': {
+                    // Only the Latin-1 range is needed for names; emit it as UTF-8
+                    unsigned code = 0;
+                    for (int i = 1; i <= 4; i++) {
+                        char c = src[i];
+                        if (!isxdigit((unsigned char)c)) return NULL;
+                        code = code * 16 + (isdigit((unsigned char)c) ? c - '0' : (tolower((unsigned char)c) - 'a' + 10));
+                    }
+                    src += 4;
+                    if (code < 0x80) {
+                        *dst++ = (char)code;
+                    } else if (code < 0x800) {
+                        *dst++ = (char)(0xC0 | (code >> 6));
+                        *dst++ = (char)(0x80 | (code & 0x3F));
+                    } else {
+                        *dst++ = '?';
+                    }
+                    break;
+                }
+                case '\0': return NULL;
+                default: *dst++ = *src; break;
+            }
+            src++;
+        } else {
+            *dst++ = *src++;
+        }
+    }
+    if (*src != '"') return NULL;
+    *dst = '\0';
+    *p = src + 1;
+    return out;
+}
+
+// Bare scalar (number, true, false, null), copied out so the delimiter stays intact
+static char *parse_scalar(char **p, char *buf, size_t size) {
+    char *start = *p;
+    char *end = start;
+    while (*end && *end != ',' && *end != '}' && *end != ']' && !isspace((unsigned char)*end)) end++;
+    size_t len = (size_t)(end - start);
+    if (len == 0 || len >= size) return NULL;
+    memcpy(buf, start, len);
+    buf[len] = '\0';
+    *p = end;
+    if (strcmp(buf, "null") == 0) buf[0] = '\0';
+    return buf;
+}
+
+static bool parse_json_record(BatchRecord *rec, char *line) {
+    char *p = skip_space(line);
+    if (*p != '{') {
+        rec->error = "expected a JSON object";
+        return false;
+    }
+    p = skip_space(p + 1);
+    if (*p == '}') return true;
+    char scalar[32];
+    while (1) {
+        if (*p != '"') {
+            rec->error = "expected a field name";
+            return false;
+        }
+        char *key = parse_string(&p);
+        if (!key) {
+            rec->error = "unterminated string";
+            return false;
+        }
+        p = skip_space(p);
+        if (*p != ':') {
+            rec->error = "expected ':'";
+            return false;
+        }
+        p = skip_space(p + 1);
+        if (*p == '[') {
+            // Arrays are only meaningful for preferred times and attendees
+            p = skip_space(p + 1);
+            bool preferred = strcmp(key, "preferred") == 0;
+            bool attendees = strcmp(key, "attendees") == 0;
+            while (*p != ']') {
+                if (attendees && *p != '"') {
+                    rec->error = "attendee names must be strings";
+                    return false;
+                }
+                char *item = *p == '"' ? parse_string(&p) : parse_scalar(&p, scalar, sizeof(scalar));
+                if (!item) {
+                    rec->error = "malformed array";
+                    return false;
+                }
+                if (preferred && !add_preferred(rec, item)) return false;
+                if (attendees && !add_attendee(rec, item)) return false;
+                p = skip_space(p);
+                if (*p == ',') p = skip_space(p + 1);
+                else if (*p != ']') {
+                    rec->error = "malformed array";
+                    return false;
+                }
+            }
+            p++;
+        } else if (*p == '{') {
+            rec->error = "nested objects are not supported";
+            return false;
+        } else {
+            char *value = *p == '"' ? parse_string(&p) : parse_scalar(&p, scalar, sizeof(scalar));
+            if (!value) {
+                rec->error = "malformed value";
+                return false;
+            }
+            if (!set_field(rec, key, value)) return false;
+        }
+        p = skip_space(p);
+        if (*p == ',') {
+            p = skip_space(p + 1);
+            continue;
+        }
+        if (*p == '}') return true;
+        rec->error = "expected ',' or '}'";
+        return false;
+    }
+}
+
+// --------------------
+// CSV records
+// --------------------
+
+// Splits a CSV line in place, honouring quotes and "" escapes
+static int split_csv(char *line, char **fields, int max_fields) {
+    int count = 0;
+    char *p = line;
+    while (count < max_fields) {
+        char *dst = p;
+        fields[count++] = dst;
+        if (*p == '"') {
+            p++;
+            while (*p) {
+                if (*p == '"' && p[1] == '"') {
+                    *dst++ = '"';
+                    p += 2;
+                } else if (*p == '"') {
+                    p++;
+                    break;
+                } else {
+                    *dst++ = *p++;
+                }
+            }
+            while (*p && *p != ',') p++;
+        } else {
+            while (*p && *p != ',' && *p != '\r' && *p != '\n') *dst++ = *p++;
+            if (*p == '\r' || *p == '\n') *p = '\0';
+        }
+        char sep = *p;
+        *dst = '\0';
+        if (sep != ',') break;
+        p++;
+    }
+    return count;
+}
+
+// --------------------
+// Driver
+// --------------------
+
+static bool append_meeting(MeetingList *list, const Meeting *meeting) {
+    if (list->count == list->capacity) {
+        int capacity = list->capacity ? list->capacity * 2 : 64;
+        Meeting *items = realloc(list->items, (size_t)capacity * sizeof(Meeting));
+        if (!items) return false;
+        list->items = items;
+        list->capacity = capacity;
+    }
+    list->items[list->count++] = *meeting;
+    return true;
+}
+
+void free_meeting_list(MeetingList *list) {
+    free(list->items);
+    list->items = NULL;
+    list->count = list->capacity = 0;
+}
+
+static int find_collected(const MeetingList *list, const char *name) {
+    for (int i = 0; i < list->count; i++) {
+        if (strcmp(list->items[i].name, name) == 0) return i;
+    }
+    return -1;
+}
+
+// A meeting that is still waiting to be placed is edited in the list: remove
+// drops the request and move pins it to the new day and time
+static bool edit_collected(MeetingList *list, int index, BatchRecord *rec, int kind, BatchStats *stats) {
+    if (kind == 2) {
+        memmove(&list->items[index], &list->items[index + 1], (size_t)(list->count - index - 1) * sizeof(Meeting));
+        list->count--;
+    } else {
+        if (find_day_index(rec->day) < 0 || find_slot_index(rec->start) < 0) {
+            rec->error = "edit rejected";
+            return false;
+        }
+        memcpy(list->items[index].fixed_day, rec->day, MAX_STR);
+        memcpy(list->items[index].fixed_time, rec->start, MAX_STR);
+    }
+    stats->edits++;
+    return true;
+}
+
+static bool apply_record(MeetingScheduler *scheduler, BatchRecord *rec, MeetingList *collect, BatchStats *stats) {
+    int kind = rec->kind >= 0 ? rec->kind : rec->meeting.name[0] != '\0';
+    if (kind == 2 || kind == 3) {
+        int pending = collect ? find_collected(collect, rec->meeting.name) : -1;
+        if (pending >= 0) return edit_collected(collect, pending, rec, kind, stats);
+        int series_idx = find_meeting(scheduler, rec->meeting.name);
+        bool ok = series_idx >= 0 &&
+                  (kind == 2 ? remove_meeting(scheduler, series_idx)
+                             : move_meeting(scheduler, series_idx, find_day_index(rec->day), find_slot_index(rec->start)));
+        if (!ok) rec->error = series_idx < 0 ? "no such meeting" : "edit rejected";
+        else stats->edits++;
+        return ok;
+    }
+    if (kind == 0 && rec->attendee[0]) {
+        int day_idx = find_day_index(rec->day);
+        int start_idx = find_slot_index(rec->start);
+        int duration_slots = minutes_to_slots(rec->duration_minutes);
+        if (day_idx < 0 || day_idx >= scheduler->day_count || start_idx < 0 || duration_slots == 0 ||
+            !(allowed_starts(duration_slots) >> start_idx & 1)) {
+            rec->error = "reservation rejected";
+            return false;
+        }
+        int person = add_person(scheduler, rec->attendee);
+        if (person < 0) {
+            rec->error = "out of memory";
+            return false;
+        }
+        if (!reserve_person_slot(scheduler, person, day_idx, start_idx, duration_slots)) {
+            rec->error = "reservation rejected";
+            return false;
+        }
+        stats->reservations++;
+        return true;
+    }
+    if (kind == 0) {
+        if (!reserve_slot(scheduler, rec->day, rec->start, rec->duration_minutes)) {
+            rec->error = "reservation rejected";
+            return false;
+        }
+        stats->reservations++;
+        return true;
+    }
+    rec->meeting.duration = minutes_to_slots(rec->duration_minutes);
+    if (rec->meeting.duration == 0) {
+        rec->error = "duration must be a whole number of slots up to the longest meeting";
+        return false;
+    }
+    int people_mark = scheduler->person_grids.count;
+    if (!register_attendees(scheduler, rec)) {
+        drop_idle_people(scheduler, people_mark);
+        return false;
+    }
+    if (collect) {
+        // The record's attendee array is reused; collected meetings keep a copy in the arena
+        if (rec->meeting.attendee_count) {
+            size_t size = rec->meeting.attendee_count * sizeof(int);
+            int *attendees = arena_alloc(&scheduler->arena, size);
+            if (!attendees) {
+                rec->error = "out of memory";
+                return false;
+            }
+            memcpy(attendees, rec->attendees, size);
+            rec->meeting.attendees = attendees;
+        }
+        if (!append_meeting(collect, &rec->meeting)) {
+            rec->error = "out of memory";
+            return false;
+        }
+        return true;
+    }
+    if (!add_meeting(scheduler, &rec->meeting)) {
+        // Attendees new with this record have empty calendars and did not constrain it
+        drop_idle_people(scheduler, people_mark);
+        rec->error = "no consistent slot";
+        return false;
+    }
+    stats->meetings++;
+    return true;
+}
+
+static bool is_blank(const char *line) {
+    while (*line == ' ' || *line == '\t' || *line == '\r' || *line == '\n') line++;
+    return *line == '\0';
+}
+
+bool run_batch(MeetingScheduler *scheduler, const char *path, BatchFormat format,
+               MeetingList *collect, BatchStats *stats) {
+    FILE *fp = strcmp(path, "-") == 0 ? stdin : fopen(path, "r");
+    if (!fp) {
+        printf("Error: Cannot open %s\n", path);
+        return false;
+    }
+    setvbuf(fp, NULL, _IOFBF, BATCH_IO_BUFFER);
+    memset(stats, 0, sizeof(*stats));
+    if (format == BATCH_AUTO) {
+        size_t len = strlen(path);
+        format = len > 4 && strcmp(path + len - 4, ".csv") == 0 ? BATCH_CSV : BATCH_JSONL;
+    }
+
+    char *line = NULL;
+    size_t capacity = 0;
+    long line_no = 0;
+    BatchRecord rec;
+    char *columns[MAX_CSV_COLUMNS];
+    char header_store[1024];
+    int column_count = 0;
+    while (getline(&line, &capacity, fp) != -1) {
+        line_no++;
+        if (is_blank(line)) continue;
+        if (format == BATCH_CSV && column_count == 0) {
+            // Header row: column names are kept for the rest of the file
+            strncpy(header_store, line, sizeof(header_store) - 1);
+            header_store[sizeof(header_store) - 1] = '\0';
+            column_count = split_csv(header_store, columns, MAX_CSV_COLUMNS);
+            continue;
+        }
+        stats->records++;
+        reset_record(&rec);
+        bool ok;
+        if (format == BATCH_CSV) {
+            char *fields[MAX_CSV_COLUMNS];
+            int field_count = split_csv(line, fields, MAX_CSV_COLUMNS);
+            ok = true;
+            for (int i = 0; i < field_count && i < column_count && ok; i++) {
+                ok = set_field(&rec, columns[i], fields[i]);
+            }
+        } else {
+            ok = parse_json_record(&rec, line);
+        }
+        if (ok) ok = apply_record(scheduler, &rec, collect, stats);
+        if (!ok) {
+            stats->failures++;
+            fprintf(stderr, "%s:%ld: %s\n", path, line_no, rec.error ? rec.error : "invalid record");
+        }
+    }
+    free(line);
+    if (fp != stdin) fclose(fp);
+    return true;
+}
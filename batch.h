@@ -0,0 +1,55 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "scheduler_core.h"
+
+// Non-interactive input: one reservation or meeting request per record.
+//
+// JSONL, one object per line:
+//   {"kind": "reservation", "day": "Monday", "start": "14:00", "duration": 60}
+//   {"kind": "meeting", "name": "BIM Review", "type": "management", "duration": 60,
+//    "preferred": ["10:00", "10:30"], "fixed_day": "", "fixed_time": "", "frequency": "fortnightly"}
+//
+//   {"kind": "meeting", "name": "All-hands", "duration": 60, "attendees": ["Ana", "Ben"]}
+//   {"kind": "reservation", "attendee": "Ana", "day": "Tuesday", "start": "10:00", "duration": 30}
+//   {"kind": "move", "name": "BIM Review", "day": "Thursday", "start": "13:00"}
+//   {"kind": "remove", "name": "BIM Review"}
+//
+// A reservation with an "attendee" blocks only that person's calendar. Move
+// and remove act on the first meeting with the given name; in collect mode a
+// meeting still waiting to be placed is edited before placed ones are looked up.
+//
+// CSV, with a header row naming the same fields in any order; "preferred"
+// holds space-separated times and "attendees" semicolon-separated names.
+// Durations are in minutes. "kind" may be omitted, in which case records
+// with a name are meetings.
+typedef enum {
+    BATCH_AUTO,
+    BATCH_JSONL,
+    BATCH_CSV
+} BatchFormat;
+
+typedef struct {
+    long records;
+    long reservations; // Reservations placed
+    long meetings; // Meetings placed
+    long edits; // Meetings moved or removed
+    long failures; // Records rejected or not placed
+} BatchStats;
+
+// Meetings read in collect mode, in file order
+typedef struct {
+    Meeting *items;
+    int count;
+    int capacity;
+} MeetingList;
+
+// Reservations are always applied as they are read. Meetings are placed with
+// add_meeting, or appended to `collect` when it is non-NULL so the caller can
+// place the whole set at once; attendees registered for collected meetings
+// that end up unplaced are the caller's to drop with drop_idle_people.
+bool run_batch(MeetingScheduler *scheduler, const char *path, BatchFormat format,
+               MeetingList *collect, BatchStats *stats);
+void free_meeting_list(MeetingList *list);
+
+#endif
@@ -0,0 +1,301 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include "scheduler_core.h"
+#include "workload.h"
+
+// Benchmark of the scheduler hot paths on a generated workload.
+//
+// Each stage is timed over --repeat runs and reported as one record:
+// operations, ns/op, success rate, placements/sec (placement stages only) and the
+// process peak RSS once the stage has finished. Records are written after
+// the last stage, as JSON lines or CSV, together with the workload options,
+// so results of two versions can be diffed or loaded directly.
+#define BENCH_VERSION 1
+
+typedef struct {
+    const char *stage;
+    long ops;
+    long successes;
+    double seconds;
+    long placements; // Meetings placed; only add_meeting and add_meetings place any
+    long peak_rss_kb;
+} StageResult;
+
+typedef struct {
+    WorkloadOptions workload;
+    int weeks;
+    int days;
+    int repeat;
+    bool csv;
+    const char *ics_path;
+    const char *output_path;
+} BenchOptions;
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s [--seed N] [--meetings N] [--reservations N] [--mix W,F,T,M]\n"
+                    "          [--fixed-day PCT] [--fixed-time PCT] [--preferred PCT] [--max-preferred N]\n"
+                    "          [--weeks N] [--days N] [--grid SPEC] [--repeat N] [--format jsonl|csv] [--ics FILE] [--output FILE]\n",
+            prog);
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static long peak_rss_kb(void) {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss; // Kilobytes on Linux
+}
+
+static void finish_stage(StageResult *result, const char *stage, long ops, long successes, double seconds) {
+    result->stage = stage;
+    result->ops = ops;
+    result->successes = successes;
+    result->seconds = seconds;
+    result->peak_rss_kb = peak_rss_kb();
+}
+
+// The display and export stages print to stdout; point it at /dev/null meanwhile
+static int silence_stdout(void) {
+    fflush(stdout);
+    int saved = dup(STDOUT_FILENO);
+    int null_fd = open("/dev/null", O_WRONLY);
+    if (null_fd >= 0) {
+        dup2(null_fd, STDOUT_FILENO);
+        close(null_fd);
+    }
+    return saved;
+}
+
+static void restore_stdout(int saved) {
+    fflush(stdout);
+    if (saved < 0) return;
+    dup2(saved, STDOUT_FILENO);
+    close(saved);
+}
+
+// Fresh calendar holding the workload's reservations
+static void prepare(MeetingScheduler *scheduler, const Workload *workload, uint64_t seed) {
+    reset_scheduler(scheduler);
+    apply_reservations(scheduler, workload);
+    seed_scheduler(scheduler, seed);
+}
+
+static void write_results(FILE *fp, const BenchOptions *options, const StageResult *results, int count) {
+    const WorkloadOptions *w = &options->workload;
+    if (options->csv) {
+        fprintf(fp, "version,stage,seed,meetings,reservations,mix,fixed_day_pct,fixed_time_pct,preferred_pct,"
+                    "weeks,days,repeat,ops,seconds,ns_per_op,success_rate,placements_per_sec,peak_rss_kb\n");
+    }
+    for (int i = 0; i < count; i++) {
+        const StageResult *r = &results[i];
+        double ns_per_op = r->ops ? r->seconds * 1e9 / r->ops : 0;
+        double success_rate = r->ops ? (double)r->successes / r->ops : 0;
+        double placements_per_sec = r->seconds > 0 ? r->placements / r->seconds : 0;
+        const char *format = options->csv
+            ? "%d,%s,%llu,%d,%d,%d:%d:%d:%d,%d,%d,%d,%d,%d,%d,%ld,%.6f,%.1f,%.4f,%.0f,%ld\n"
+            : "{\"version\": %d, \"stage\": \"%s\", \"seed\": %llu, \"meetings\": %d, \"reservations\": %d, "
+              "\"mix\": [%d, %d, %d, %d], \"fixed_day_pct\": %d, \"fixed_time_pct\": %d, \"preferred_pct\": %d, "
+              "\"weeks\": %d, \"days\": %d, \"repeat\": %d, \"ops\": %ld, \"seconds\": %.6f, \"ns_per_op\": %.1f, "
+              "\"success_rate\": %.4f, \"placements_per_sec\": %.0f, \"peak_rss_kb\": %ld}\n";
+        fprintf(fp, format, BENCH_VERSION, r->stage, (unsigned long long)w->seed, w->meetings, w->reservations,
+                w->frequency_mix[0], w->frequency_mix[1], w->frequency_mix[2], w->frequency_mix[3],
+                w->fixed_day_percent, w->fixed_time_percent, w->preferred_percent, options->weeks, options->days,
+                options->repeat, r->ops, r->seconds, ns_per_op, success_rate, placements_per_sec, r->peak_rss_kb);
+    }
+}
+
+static bool parse_options(int argc, char **argv, BenchOptions *options) {
+    workload_defaults(&options->workload);
+    options->weeks = 52;
+    options->days = 5;
+    options->repeat = 100;
+    options->csv = false;
+    options->ics_path = "/dev/null";
+    options->output_path = NULL;
+    WorkloadOptions *w = &options->workload;
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (!value) return false;
+        i++;
+        if (strcmp(arg, "--seed") == 0) {
+            w->seed = strtoull(value, NULL, 10);
+        } else if (strcmp(arg, "--meetings") == 0) {
+            w->meetings = atoi(value);
+        } else if (strcmp(arg, "--reservations") == 0) {
+            w->reservations = atoi(value);
+        } else if (strcmp(arg, "--mix") == 0) {
+            if (sscanf(value, "%d,%d,%d,%d", &w->frequency_mix[0], &w->frequency_mix[1],
+                       &w->frequency_mix[2], &w->frequency_mix[3]) != FREQ_COUNT) return false;
+        } else if (strcmp(arg, "--fixed-day") == 0) {
+            w->fixed_day_percent = atoi(value);
+        } else if (strcmp(arg, "--fixed-time") == 0) {
+            w->fixed_time_percent = atoi(value);
+        } else if (strcmp(arg, "--preferred") == 0) {
+            w->preferred_percent = atoi(value);
+        } else if (strcmp(arg, "--max-preferred") == 0) {
+            w->max_preferred = atoi(value);
+        } else if (strcmp(arg, "--weeks") == 0) {
+            options->weeks = atoi(value);
+        } else if (strcmp(arg, "--grid") == 0) {
+            GridConfig grid = *grid_config();
+            if (!parse_grid_config(value, &grid) || !configure_grid(&grid)) return false;
+        } else if (strcmp(arg, "--days") == 0) {
+            options->days = atoi(value);
+        } else if (strcmp(arg, "--repeat") == 0) {
+            options->repeat = atoi(value);
+        } else if (strcmp(arg, "--format") == 0) {
+            if (strcmp(value, "jsonl") != 0 && strcmp(value, "csv") != 0) return false;
+            options->csv = strcmp(value, "csv") == 0;
+        } else if (strcmp(arg, "--ics") == 0) {
+            options->ics_path = value;
+        } else if (strcmp(arg, "--output") == 0) {
+            options->output_path = value;
+        } else {
+            return false;
+        }
+    }
+    return options->weeks >= 1 && options->weeks <= MAX_HORIZON_WEEKS && options->days >= 1 &&
+           options->days <= MAX_DAYS && options->repeat >= 1;
+}
+
+int main(int argc, char **argv) {
+    BenchOptions options;
+    if (!parse_options(argc, argv, &options)) {
+        usage(argv[0]);
+        return 1;
+    }
+    StageResult results[10] = {{0}};
+    int stage = 0;
+    int repeat = options.repeat;
+
+    // Workload generation
+    Workload workload;
+    double started = now_seconds();
+    bool generated = true;
+    for (int r = 0; r < repeat && generated; r++) {
+        if (r > 0) free_workload(&workload);
+        generated = generate_workload(&workload, &options.workload, options.days);
+    }
+    if (!generated) return 1;
+    finish_stage(&results[stage++], "generate", (long)workload.count * repeat, (long)workload.count * repeat,
+                 now_seconds() - started);
+
+    MeetingScheduler scheduler;
+    if (!init_scheduler_days(&scheduler, options.weeks, options.days)) {
+        printf("Error: Out of memory\n");
+        free_scheduler(&scheduler);
+        free_workload(&workload);
+        return 1;
+    }
+
+    // Reservations on an empty calendar
+    double seconds = 0;
+    long applied = 0;
+    for (int r = 0; r < repeat; r++) {
+        reset_scheduler(&scheduler);
+        started = now_seconds();
+        applied += apply_reservations(&scheduler, &workload);
+        seconds += now_seconds() - started;
+    }
+    finish_stage(&results[stage++], "reserve", (long)workload.reservation_count * repeat, applied, seconds);
+
+    // Greedy placement of the whole meeting list, in order
+    seconds = 0;
+    long placed = 0;
+    for (int r = 0; r < repeat; r++) {
+        prepare(&scheduler, &workload, options.workload.seed);
+        started = now_seconds();
+        for (int m = 0; m < workload.count; m++) {
+            if (try_add_meeting(&scheduler, &workload.meetings[m])) placed++;
+        }
+        seconds += now_seconds() - started;
+    }
+    finish_stage(&results[stage], "add_meeting", (long)workload.count * repeat, placed, seconds);
+    results[stage++].placements = placed;
+
+    // Every (week, day, start, duration) of the final calendar
+    long checks = 0, valid = 0;
+    started = now_seconds();
+    for (int r = 0; r < repeat; r++) {
+        for (int week = 0; week < scheduler.week_count; week++) {
+            for (int day = 0; day < scheduler.day_count; day++) {
+                for (int slot = 0; slot < slot_count(); slot++) {
+                    for (int duration = 1; duration <= max_duration_slots(); duration++) {
+                        valid += is_valid_slot(&scheduler, week, day, slot, duration);
+                        checks++;
+                    }
+                }
+            }
+        }
+    }
+    finish_stage(&results[stage++], "is_valid_slot", checks, valid, now_seconds() - started);
+
+    // Top five free slots for every meeting of the list against the final calendar
+    FreeSlot slots[5];
+    long queries = 0, answered = 0;
+    started = now_seconds();
+    for (int r = 0; r < repeat; r++) {
+        for (int m = 0; m < workload.count; m++) {
+            answered += find_free_slots(&scheduler, &workload.meetings[m], slots, 5) > 0;
+            queries++;
+        }
+    }
+    finish_stage(&results[stage++], "find_free_slots", queries, answered, now_seconds() - started);
+
+    int saved = silence_stdout();
+    started = now_seconds();
+    for (int r = 0; r < repeat; r++) display_schedule(&scheduler);
+    fflush(stdout);
+    finish_stage(&results[stage++], "display_schedule", repeat, repeat, now_seconds() - started);
+
+    // The machine-readable renderers over the same calendar
+    const ScheduleFormat formats[] = {SCHEDULE_JSON, SCHEDULE_CSV};
+    const char *format_stages[] = {"write_schedule_json", "write_schedule_csv"};
+    for (int f = 0; f < 2; f++) {
+        long written = 0;
+        started = now_seconds();
+        for (int r = 0; r < repeat; r++) written += write_schedule(&scheduler, formats[f], stdout);
+        fflush(stdout);
+        finish_stage(&results[stage++], format_stages[f], repeat, written, now_seconds() - started);
+    }
+
+    started = now_seconds();
+    for (int r = 0; r < repeat; r++) export_to_ics(&scheduler, options.ics_path);
+    finish_stage(&results[stage++], "export_to_ics", repeat, repeat, now_seconds() - started);
+    restore_stdout(saved);
+
+    // The same list placed as one batch, most constrained first
+    seconds = 0;
+    placed = 0;
+    for (int r = 0; r < repeat; r++) {
+        prepare(&scheduler, &workload, options.workload.seed);
+        started = now_seconds();
+        int batch = try_add_meetings(&scheduler, workload.meetings, workload.count, NULL);
+        seconds += now_seconds() - started;
+        if (batch > 0) placed += batch;
+    }
+    finish_stage(&results[stage], "add_meetings", (long)workload.count * repeat, placed, seconds);
+    results[stage++].placements = placed;
+
+    free_scheduler(&scheduler);
+    free_workload(&workload);
+
+    FILE *fp = options.output_path ? fopen(options.output_path, "w") : stdout;
+    if (!fp) {
+        printf("Error: Cannot open %s\n", options.output_path);
+        return 1;
+    }
+    write_results(fp, &options, results, stage);
+    if (fp != stdout) fclose(fp);
+    return 0;
+}
@@ -1,7 +1,6 @@
 import calendar
-import matplotlib.pyplot as plt
-import matplotlib.patches as mpatches
 from datetime import datetime
+from scheduler_lib import render_month
 
 # Set up calendar for May 2025
 cal = calendar.monthcalendar(2025, 5)
@@ -83,96 +82,40 @@ text_colors = {
     "black": "white"       
 }
 
-# Create figure and axis
-fig, ax = plt.subplots(figsize=(16, 12))
-ax.set_title(month_name + " - Airfield Rehabilitation Project", fontsize=16, pad=20)
-
-# Set up grid
-ax.set_xticks(range(7))
-ax.set_xticklabels(days_in_week, fontsize=12)
-ax.set_yticks(range(len(cal)))
-ax.set_yticklabels([f"Week {i+1}" for i in range(len(cal))], fontsize=12)
-
-# Customize grid
-ax.grid(True, which="both", linestyle="--", linewidth=0.5)
-ax.set_xlim(-0.5, 6.5)
-ax.set_ylim(-0.5, len(cal) - 0.5)
-ax.invert_yaxis()  # Top-left is Monday, Week 1
-
-# Function to convert time to minutes past 9:00 AM
+# Function to convert time to minutes past midnight, clamped to the 9:00 AM to 5:00 PM day
 def time_to_minutes(time_str):
     # Extract time from the meeting string (e.g., "10:00 AM" from "Ian 1:1 10:00 AM")
     time_part = time_str.split()[-2] + " " + time_str.split()[-1]  # e.g., "10:00 AM"
     time_obj = datetime.strptime(time_part, "%H:%M %p")
-    hours = time_obj.hour
-    minutes = time_obj.minute
-    # Convert to minutes past midnight
-    total_minutes = hours * 60 + minutes
-    # Adjust for 9:00 AM start (9:00 AM = 540 minutes past midnight)
-    minutes_past_9am = total_minutes - (9 * 60)
-    if minutes_past_9am < 0:  # Handle times before 9:00 AM (unlikely, but for robustness)
-        minutes_past_9am = 0
-    if minutes_past_9am > 480:  # Handle times after 5:00 PM (480 minutes = 8 hours)
-        minutes_past_9am = 480
-    return minutes_past_9am
+    total_minutes = time_obj.hour * 60 + time_obj.minute
+    return min(max(total_minutes, 9 * 60), 17 * 60)
 
-# Plot days
+# Build the day cells and meeting bars (Monday first, one row per week)
+cells = []
+events = []
 for week_idx, week in enumerate(cal):
     for day_idx, day in enumerate(week):
         if day == 0:  # No day in this slot
-            ax.add_patch(mpatches.Rectangle((day_idx - 0.5, week_idx - 0.5), 1, 1, color="lightgrey"))
+            cells.append((0, "lightgrey", None))
             continue
 
-        # Determine cell color (white for all days except holidays)
-        cell_color = "white"  # Default: all days are white
-        if (5, day) in sa_holidays or (5, day) in uk_holidays:
-            cell_color = "salmon"  # Holiday
-
-        # Draw cell
-        ax.add_patch(
-            mpatches.Rectangle((day_idx - 0.5, week_idx - 0.5), 1, 1,
-                               facecolor=cell_color, edgecolor="black")
-        )
-
-        # Add day number in the top-left corner (avoid overlap)
-        ax.text(day_idx - 0.48, week_idx - 0.48, str(day),
-                ha="left", va="top", fontsize=12, weight="bold", zorder=5)
-
-        # Add holiday label
+        # Holidays are salmon with a label; every other day is white
         if (5, day) in sa_holidays:
-            ax.text(day_idx, week_idx + 0.4, "SA: Workers’ Day", ha="center", va="bottom", 
-                    fontsize=8, color="darkred", wrap=True)
+            cells.append((day, "salmon", "SA: Workers’ Day"))
         elif (5, day) in uk_holidays:
-            ax.text(day_idx, week_idx + 0.4, "UK: Bank Holiday", ha="center", va="bottom", 
-                    fontsize=8, color="darkred", wrap=True)
-
-        # Add meetings with time-based positioning and filled boxes
-        if (5, day) in meetings:
-            meeting_list = meetings[(5, day)]
-            for meeting in meeting_list:
-                # Extract the meeting type (full prefix, e.g., "Roll-A 1:1")
-                meeting_type = " ".join(meeting.split(" ")[:2])  # e.g., "Ian 1:1", "Roll-A 1:1"
-                fill_color = meeting_colors.get(meeting_type, "black")
-                text_color = text_colors.get(fill_color, "white")  # Default text = white if not found
-
-                # Calculate position based on time (9:00 AM to 5:00 PM = 1.0 height)
-                minutes_past_9am = time_to_minutes(meeting)
-                # Map minutes to y-position (0 to 480 minutes -> 0 to 1.0 in cell)
-                y_offset = (minutes_past_9am / 480.0)  # 480 minutes = 8 hours
-                y_position = (week_idx - 0.5) + y_offset
-
-                # Add meeting text with a filled box
-                ax.text(
-                    day_idx, y_position, meeting,
-                    ha="center", va="center", fontsize=6,
-                    color=text_color,
-                    bbox=dict(facecolor=fill_color, edgecolor="black", boxstyle="round,pad=0.2"),
-                    wrap=True
-                )
-
-# Adjust layout (no legend needed here)
-plt.tight_layout()
-
-# Save and show
-plt.savefig("may_2025_calendar_updated.png", dpi=300, bbox_inches="tight")
-plt.show()
+            cells.append((day, "salmon", "UK: Bank Holiday"))
+        else:
+            cells.append((day, "white", None))
+
+        # Add meetings positioned by start time, with a filled bar
+        for meeting in meetings.get((5, day), []):
+            # Extract the meeting type (full prefix, e.g., "Roll-A 1:1")
+            meeting_type = " ".join(meeting.split(" ")[:2])  # e.g., "Ian 1:1", "Roll-A 1:1"
+            fill_color = meeting_colors.get(meeting_type, "black")
+            text_color = text_colors.get(fill_color, "white")  # Default text = white if not found
+            events.append((week_idx * 7 + day_idx, time_to_minutes(meeting), 30, fill_color, text_color, meeting))
+
+# Render with the native month view renderer (libscheduler.so)
+image = render_month(month_name + " - Airfield Rehabilitation Project", len(cal), cells, events, image_format="png")
+with open("may_2025_calendar_updated.png", "wb") as f:
+    f.write(image)
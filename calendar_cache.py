@@ -0,0 +1,68 @@
+"""
+Content-addressed cache for computed calendars, shared by every app worker.
+
+Entries live in one SQLite file, keyed by a hash of the normalized meeting
+list, and the least recently viewed entries are evicted beyond a fixed count.
+An entry never goes stale: a different meeting list hashes to a different key.
+"""
+import hashlib
+import json
+import os
+import sqlite3
+import tempfile
+import time
+
+# Fields that affect placement or drawing; "order" only sorts the list
+MEETING_FIELDS = ("meeting_type", "time_slot", "recurrence", "preferred_day", "person_name")
+
+
+def calendar_key(meetings, *context):
+    """Hash of the meetings in order, plus anything else the result depends on."""
+    ordered = sorted(meetings, key=lambda m: m.get("order", 0))
+    normalized = [[m.get(field) or "" for field in MEETING_FIELDS] for m in ordered]
+    text = json.dumps([normalized, list(context)], separators=(",", ":"), ensure_ascii=False)
+    return hashlib.sha256(text.encode()).hexdigest()
+
+
+class CalendarCache:
+    """Bounded LRU of JSON values in a SQLite file; safe across processes."""
+
+    def __init__(self, path=None, max_entries=256):
+        self.path = path or os.path.join(tempfile.gettempdir(), "meeting_calendar_cache.sqlite3")
+        self.max_entries = max_entries
+        self._connection = None
+        self._pid = None
+
+    def _db(self):
+        # Connections must not cross a fork, so each worker process opens its own
+        if self._connection is None or self._pid != os.getpid():
+            connection = sqlite3.connect(self.path, timeout=10, isolation_level=None)
+            connection.execute("PRAGMA journal_mode=WAL")
+            connection.execute("PRAGMA synchronous=NORMAL")
+            connection.execute("CREATE TABLE IF NOT EXISTS calendars "
+                               "(key TEXT PRIMARY KEY, value TEXT NOT NULL, used REAL NOT NULL)")
+            connection.execute("CREATE INDEX IF NOT EXISTS calendars_used ON calendars (used)")
+            self._connection, self._pid = connection, os.getpid()
+        return self._connection
+
+    def get(self, key):
+        """The cached value, or None; a hit marks the entry as recently used."""
+        db = self._db()
+        row = db.execute("SELECT value FROM calendars WHERE key = ?", (key,)).fetchone()
+        if row is None:
+            return None
+        db.execute("UPDATE calendars SET used = ? WHERE key = ?", (time.time(), key))
+        return json.loads(row[0])
+
+    def put(self, key, value):
+        db = self._db()
+        with db:
+            db.execute("BEGIN IMMEDIATE")
+            db.execute("INSERT OR REPLACE INTO calendars (key, value, used) VALUES (?, ?, ?)",
+                       (key, json.dumps(value), time.time()))
+            db.execute("DELETE FROM calendars WHERE key IN (SELECT key FROM calendars "
+                       "ORDER BY used DESC LIMIT -1 OFFSET ?)", (self.max_entries,))
+
+    def clear(self):
+        db = self._db()
+        db.execute("DELETE FROM calendars")
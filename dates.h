@@ -0,0 +1,32 @@
+#ifndef DATES_H
+#define DATES_H
+
+// Proleptic Gregorian dates as day numbers (days since 1970-01-01), so date
+// arithmetic is integer addition and no mktime/strftime is needed.
+static inline long days_from_civil(int year, int month, int day) {
+    year -= month <= 2;
+    long era = (year >= 0 ? year : year - 399) / 400;
+    unsigned yoe = (unsigned)(year - era * 400);
+    unsigned doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + (long)doe - 719468;
+}
+
+static inline void civil_from_days(long days, int *year, int *month, int *day) {
+    days += 719468;
+    long era = (days >= 0 ? days : days - 146096) / 146097;
+    unsigned doe = (unsigned)(days - era * 146097);
+    unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    unsigned mp = (5 * doy + 2) / 153;
+    *day = (int)(doy - (153 * mp + 2) / 5 + 1);
+    *month = (int)(mp < 10 ? mp + 3 : mp - 9);
+    *year = (int)(yoe + era * 400 + (*month <= 2));
+}
+
+// 0 = Monday ... 6 = Sunday
+static inline int weekday_from_days(long days) {
+    return (int)((days % 7 + 10) % 7);
+}
+
+#endif
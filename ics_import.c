@@ -0,0 +1,509 @@
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include "ics_import.h"
+#include "dates.h"
+
+#define ICS_IO_BUFFER (1 << 20)
+#define MINUTES_PER_DAY (24 * 60)
+#define MAX_BYDAY 16
+#define MAX_BYMONTHDAY 31
+#define MAX_PERIOD_DAYS (12 * (31 + MAX_BYDAY)) // A YEARLY period selecting every month
+
+typedef enum {
+    RULE_NONE,
+    RULE_DAILY,
+    RULE_WEEKLY,
+    RULE_MONTHLY,
+    RULE_YEARLY,
+    RULE_UNSUPPORTED // HOURLY and finer
+} RuleFrequency;
+
+typedef struct {
+    RuleFrequency frequency;
+    int interval;
+    long count; // 0 for no limit
+    bool has_until;
+    long until_day;
+    int until_minute;
+    uint8_t weekdays; // BYDAY without an ordinal, bit 0 = Monday
+    int ordinal_count; // BYDAY with one, e.g. 2TU or -1FR
+    int8_t ordinals[MAX_BYDAY];
+    uint8_t ordinal_days[MAX_BYDAY];
+    int monthday_count;
+    int8_t monthdays[MAX_BYMONTHDAY]; // Negative counts from the end of the month
+    uint16_t months; // BYMONTH, bit 0 = January
+} IcsRule;
+
+// The VEVENT being read
+typedef struct {
+    bool has_start;
+    bool all_day;
+    long start_day;
+    int start_minute;
+    bool has_end;
+    long end_day;
+    int end_minute;
+    long duration; // Minutes, or -1 when DURATION was not given
+    bool inactive; // Cancelled or transparent
+    IcsRule rule;
+    int exdate_count;
+    long exdates[ICS_MAX_EXDATES]; // Day numbers
+} IcsEvent;
+
+typedef struct {
+    MeetingScheduler *scheduler;
+    SlotMask *grid; // Occupancy or a person grid
+    FILE *fp;
+    IcsImportStats *stats;
+    char line[ICS_MAX_LINE];
+    IcsEvent event;
+} IcsImport;
+
+// --------------------
+// Reading
+// --------------------
+
+// Reads the next content line with its folds joined and its line break
+// removed; false at the end of the input
+static bool next_line(IcsImport *import) {
+    FILE *fp = import->fp;
+    size_t len = 0;
+    int c = getc_unlocked(fp);
+    if (c == EOF) return false;
+    while (c != EOF) {
+        if (c == '\n') {
+            // A line starting with a space or tab continues this one
+            int next = getc_unlocked(fp);
+            if (next != ' ' && next != '\t') {
+                if (next != EOF) ungetc(next, fp);
+                break;
+            }
+        } else if (c != '\r' && len + 1 < sizeof(import->line)) {
+            import->line[len++] = (char)c;
+        }
+        c = getc_unlocked(fp);
+    }
+    import->line[len] = '\0';
+    return true;
+}
+
+static int parse_digits(const char *text, int count) {
+    int value = 0;
+    for (int i = 0; i < count; i++) {
+        if (text[i] < '0' || text[i] > '9') return -1;
+        value = value * 10 + (text[i] - '0');
+    }
+    return value;
+}
+
+// "YYYYMMDD" or "YYYYMMDDTHHMMSS", optionally followed by Z; *minute is -1
+// for a date. Returns the characters used, or 0. Each field is checked before
+// the next is read: parse_digits stops at the NUL of a short value, and the
+// following field would start past it.
+static int parse_ics_time(const char *text, long *day, int *minute) {
+    int year, month, mday;
+    if ((year = parse_digits(text, 4)) < 0 || (month = parse_digits(text + 4, 2)) < 1 || month > 12 ||
+        (mday = parse_digits(text + 6, 2)) < 1 || mday > 31) {
+        return 0;
+    }
+    *day = days_from_civil(year, month, mday);
+    *minute = -1;
+    if (text[8] != 'T') return 8;
+    int hour, min;
+    if ((hour = parse_digits(text + 9, 2)) < 0 || hour > 23 || (min = parse_digits(text + 11, 2)) < 0 ||
+        min > 59 || parse_digits(text + 13, 2) < 0) {
+        return 0;
+    }
+    *minute = hour * 60 + min;
+    return text[15] == 'Z' ? 16 : 15;
+}
+
+// "P1W", "P1DT2H", "PT1H30M" and so on, in minutes (seconds are rounded
+// up); -1 when negative or malformed
+static long parse_duration(const char *text) {
+    if (*text == '+') text++;
+    if (*text++ != 'P') return -1;
+    long minutes = 0;
+    bool time = false;
+    while (*text) {
+        if (*text == 'T') {
+            time = true;
+            text++;
+            continue;
+        }
+        char *end;
+        long value = strtol(text, &end, 10);
+        if (end == text || value < 0) return -1;
+        switch (*end) {
+            case 'W': minutes += value * 7 * MINUTES_PER_DAY; break;
+            case 'D': minutes += value * MINUTES_PER_DAY; break;
+            case 'H': if (!time) return -1; minutes += value * 60; break;
+            case 'M': if (!time) return -1; minutes += value; break;
+            case 'S': if (!time) return -1; minutes += (value + 59) / 60; break;
+            default: return -1;
+        }
+        text = end + 1;
+    }
+    return minutes;
+}
+
+static int parse_weekday(const char *text) {
+    static const char names[7][3] = {"MO", "TU", "WE", "TH", "FR", "SA", "SU"};
+    for (int d = 0; d < 7; d++) {
+        if (strncasecmp(text, names[d], 2) == 0) return d;
+    }
+    return -1;
+}
+
+// Other rule parts (BYSETPOS, BYHOUR, WKST...) are ignored
+static void parse_rule(IcsRule *rule, char *text) {
+    memset(rule, 0, sizeof(*rule));
+    rule->frequency = RULE_UNSUPPORTED;
+    rule->interval = 1;
+    for (char *save = NULL, *part = strtok_r(text, ";", &save); part; part = strtok_r(NULL, ";", &save)) {
+        char *value = strchr(part, '=');
+        if (!value) continue;
+        *value++ = '\0';
+        if (strcasecmp(part, "FREQ") == 0) {
+            rule->frequency = strcasecmp(value, "DAILY") == 0 ? RULE_DAILY :
+                              strcasecmp(value, "WEEKLY") == 0 ? RULE_WEEKLY :
+                              strcasecmp(value, "MONTHLY") == 0 ? RULE_MONTHLY :
+                              strcasecmp(value, "YEARLY") == 0 ? RULE_YEARLY : RULE_UNSUPPORTED;
+        } else if (strcasecmp(part, "INTERVAL") == 0) {
+            rule->interval = atoi(value) > 0 ? atoi(value) : 1;
+        } else if (strcasecmp(part, "COUNT") == 0) {
+            rule->count = atol(value) > 0 ? atol(value) : 0;
+        } else if (strcasecmp(part, "UNTIL") == 0) {
+            rule->has_until = parse_ics_time(value, &rule->until_day, &rule->until_minute) > 0;
+            if (rule->until_minute < 0) rule->until_minute = MINUTES_PER_DAY - 1;
+        } else if (strcasecmp(part, "BYDAY") == 0) {
+            for (char *s = NULL, *item = strtok_r(value, ",", &s); item; item = strtok_r(NULL, ",", &s)) {
+                char *end;
+                long ordinal = strtol(item, &end, 10);
+                int weekday = parse_weekday(end);
+                if (weekday < 0) continue;
+                if (ordinal == 0) {
+                    rule->weekdays |= (uint8_t)(1u << weekday);
+                } else if (rule->ordinal_count < MAX_BYDAY && ordinal >= -5 && ordinal <= 5) {
+                    rule->ordinals[rule->ordinal_count] = (int8_t)ordinal;
+                    rule->ordinal_days[rule->ordinal_count++] = (uint8_t)weekday;
+                }
+            }
+        } else if (strcasecmp(part, "BYMONTHDAY") == 0) {
+            for (char *s = NULL, *item = strtok_r(value, ",", &s); item; item = strtok_r(NULL, ",", &s)) {
+                int day = atoi(item);
+                if (day != 0 && day >= -31 && day <= 31 && rule->monthday_count < MAX_BYMONTHDAY) {
+                    rule->monthdays[rule->monthday_count++] = (int8_t)day;
+                }
+            }
+        } else if (strcasecmp(part, "BYMONTH") == 0) {
+            for (char *s = NULL, *item = strtok_r(value, ",", &s); item; item = strtok_r(NULL, ",", &s)) {
+                int month = atoi(item);
+                if (month >= 1 && month <= 12) rule->months |= (uint16_t)(1u << (month - 1));
+            }
+        }
+    }
+}
+
+// --------------------
+// Expansion
+// --------------------
+
+static int days_in_month(int year, int month) {
+    return (int)(days_from_civil(year + month / 12, month % 12 + 1, 1) - days_from_civil(year, month, 1));
+}
+
+// Sorts a period's days and drops repeats, e.g. from BYDAY=MO,1MO; returns the new count
+static int sort_days(long *days, int count) {
+    for (int i = 1; i < count; i++) {
+        long day = days[i];
+        int j = i;
+        while (j > 0 && days[j - 1] > day) {
+            days[j] = days[j - 1];
+            j--;
+        }
+        days[j] = day;
+    }
+    int unique = 0;
+    for (int i = 0; i < count; i++) {
+        if (unique == 0 || days[unique - 1] != days[i]) days[unique++] = days[i];
+    }
+    return unique;
+}
+
+// Days of one month the rule selects, appended to `out`
+static int month_days(const IcsEvent *event, int year, int month, long *out) {
+    const IcsRule *rule = &event->rule;
+    long first = days_from_civil(year, month, 1);
+    int length = days_in_month(year, month);
+    int count = 0;
+    if (rule->monthday_count) {
+        for (int i = 0; i < rule->monthday_count; i++) {
+            int day = rule->monthdays[i] > 0 ? rule->monthdays[i] : length + 1 + rule->monthdays[i];
+            if (day < 1 || day > length) continue;
+            // With BYDAY as well, a month day must also fall on one of its weekdays
+            if (rule->weekdays && !(rule->weekdays >> weekday_from_days(first + day - 1) & 1)) continue;
+            out[count++] = first + day - 1;
+        }
+    } else if (rule->weekdays || rule->ordinal_count) {
+        int first_weekday = weekday_from_days(first);
+        for (int day = 0; day < length; day++) {
+            if (rule->weekdays >> ((first_weekday + day) % 7) & 1) out[count++] = first + day;
+        }
+        for (int i = 0; i < rule->ordinal_count; i++) {
+            int offset = (rule->ordinal_days[i] - first_weekday + 7) % 7; // First such weekday
+            int nth = rule->ordinals[i];
+            int weeks = (length - 1 - offset) / 7 + 1;
+            if (nth < 0) nth += weeks + 1;
+            if (nth >= 1 && nth <= weeks) out[count++] = first + offset + (nth - 1) * 7;
+        }
+    } else {
+        int year0, month0, day0;
+        civil_from_days(event->start_day, &year0, &month0, &day0);
+        if (day0 <= length) out[count++] = first + day0 - 1;
+    }
+    return count;
+}
+
+// First day of recurrence period `p`
+static long period_start(const IcsEvent *event, long p) {
+    const IcsRule *rule = &event->rule;
+    int year, month, day;
+    civil_from_days(event->start_day, &year, &month, &day);
+    switch (rule->frequency) {
+        case RULE_DAILY: return event->start_day + p * rule->interval;
+        case RULE_WEEKLY: return event->start_day - weekday_from_days(event->start_day) + p * rule->interval * 7;
+        case RULE_MONTHLY: {
+            long index = (long)year * 12 + (month - 1) + p * rule->interval;
+            return days_from_civil((int)(index / 12), (int)(index % 12) + 1, 1);
+        }
+        default: return days_from_civil(year + (int)(p * rule->interval), 1, 1);
+    }
+}
+
+// Start days of period `p`, in ascending order; out holds MAX_PERIOD_DAYS
+static int period_days(const IcsEvent *event, long p, long *out) {
+    const IcsRule *rule = &event->rule;
+    long first = period_start(event, p);
+    int count = 0;
+    switch (rule->frequency) {
+        case RULE_DAILY:
+            if (!rule->weekdays || rule->weekdays >> weekday_from_days(first) & 1) out[count++] = first;
+            break;
+        case RULE_WEEKLY: {
+            uint8_t weekdays = rule->weekdays ? rule->weekdays : (uint8_t)(1u << weekday_from_days(event->start_day));
+            for (int d = 0; d < 7; d++) {
+                if (weekdays >> d & 1) out[count++] = first + d;
+            }
+            break;
+        }
+        case RULE_MONTHLY: {
+            int year, month, day;
+            civil_from_days(first, &year, &month, &day);
+            count = month_days(event, year, month, out);
+            break;
+        }
+        default: {
+            int year, month, day, start_year, start_month, start_mday;
+            civil_from_days(first, &year, &month, &day);
+            civil_from_days(event->start_day, &start_year, &start_month, &start_mday);
+            uint16_t months = rule->months ? rule->months : (uint16_t)(1u << (start_month - 1));
+            for (int m = 1; m <= 12; m++) {
+                if (months >> (m - 1) & 1) count += month_days(event, year, m, out + count);
+            }
+            break;
+        }
+    }
+    return sort_days(out, count);
+}
+
+// Blocks the slots one occurrence overlaps on each working day of the
+// horizon it touches; true when it touches the horizon at all
+static bool block_occurrence(IcsImport *import, long day, int minute, long duration) {
+    const MeetingScheduler *scheduler = import->scheduler;
+    long horizon_start = scheduler->start_date;
+    long horizon_days = (long)scheduler->week_count * 7;
+    long end = minute + duration; // Minutes after the start day's midnight
+    long first = day < horizon_start ? horizon_start - day : 0;
+    bool inside = false;
+    for (long k = first; k * MINUTES_PER_DAY < end; k++) {
+        long offset = day + k - horizon_start;
+        if (offset >= horizon_days) break;
+        inside = true;
+        int day_idx = (int)(offset % 7);
+        if (day_idx >= scheduler->day_count) continue;
+        long from = minute - k * MINUTES_PER_DAY, to = end - k * MINUTES_PER_DAY;
+        SlotMask mask = slots_overlapping(from > 0 ? (int)from : 0, to < MINUTES_PER_DAY ? (int)to : MINUTES_PER_DAY);
+        import->grid[(size_t)(offset / 7) * MAX_DAYS + day_idx] |= mask;
+    }
+    return inside;
+}
+
+static int compare_days(const void *a, const void *b) {
+    long x = *(const long *)a, y = *(const long *)b;
+    return (x > y) - (x < y);
+}
+
+// Expands the finished event over the horizon
+static void apply_event(IcsImport *import) {
+    IcsEvent *event = &import->event;
+    IcsRule *rule = &event->rule;
+    IcsImportStats *stats = import->stats;
+    stats->events++;
+    long duration = event->duration;
+    if (duration < 0 && event->has_end) {
+        duration = (event->end_day - event->start_day) * MINUTES_PER_DAY + event->end_minute - event->start_minute;
+    }
+    if (duration < 0) duration = event->all_day ? MINUTES_PER_DAY : 0;
+    if (event->inactive || !event->has_start || duration <= 0 || rule->frequency == RULE_UNSUPPORTED) {
+        stats->skipped++;
+        return;
+    }
+    int minute = event->start_minute;
+    if (rule->frequency == RULE_NONE) {
+        if (block_occurrence(import, event->start_day, minute, duration)) stats->occurrences++;
+        return;
+    }
+
+    const MeetingScheduler *scheduler = import->scheduler;
+    long horizon_end = scheduler->start_date + (long)scheduler->week_count * 7; // Exclusive
+    long last = rule->has_until && rule->until_day < horizon_end - 1 ? rule->until_day : horizon_end - 1;
+    // Periods that end, with the occurrence's length, before the horizon starts
+    long reach = scheduler->start_date - (minute + duration) / MINUTES_PER_DAY;
+    qsort(event->exdates, event->exdate_count, sizeof(long), compare_days);
+    int exdate = 0;
+    long remaining = rule->count ? rule->count : -1;
+    long days[MAX_PERIOD_DAYS];
+    for (long p = 0; period_start(event, p) <= last && remaining != 0; p++) {
+        if (p == 1 && (rule->frequency == RULE_WEEKLY || (rule->frequency == RULE_DAILY && !rule->weekdays))) {
+            // Every later period has the same number of occurrences, so whole
+            // periods before the horizon are skipped by arithmetic
+            long span = rule->frequency == RULE_WEEKLY ? 7L * rule->interval : rule->interval;
+            long tail = rule->frequency == RULE_WEEKLY ? 6 : 0;
+            long target = (reach - tail - period_start(event, 0) + span - 1) / span;
+            if (target > 1) {
+                int per_period = rule->frequency == RULE_WEEKLY ? period_days(event, 1, days) : 1;
+                if (remaining > 0 && (target - 1) * per_period >= remaining) break;
+                if (remaining > 0) remaining -= (target - 1) * per_period;
+                p = target;
+                if (period_start(event, p) > last) break;
+            }
+        }
+        int count = period_days(event, p, days);
+        for (int i = 0; i < count && remaining != 0; i++) {
+            long day = days[i];
+            if (day < event->start_day) continue;
+            if (rule->has_until && (day > rule->until_day || (day == rule->until_day && minute > rule->until_minute))) {
+                remaining = 0;
+                break;
+            }
+            if (remaining > 0) remaining--;
+            if (day > last) {
+                remaining = 0;
+                break;
+            }
+            while (exdate < event->exdate_count && event->exdates[exdate] < day) exdate++;
+            if (exdate < event->exdate_count && event->exdates[exdate] == day) continue;
+            if (block_occurrence(import, day, minute, duration)) stats->occurrences++;
+        }
+    }
+}
+
+// --------------------
+// Properties
+// --------------------
+
+// Applies one property line of the current event
+static void read_property(IcsImport *import, char *line) {
+    IcsEvent *event = &import->event;
+    // NAME;PARAM=...;PARAM="...:...":VALUE; the value starts at the first colon outside quotes
+    char *value = line;
+    bool quoted = false;
+    while (*value && (quoted || *value != ':')) {
+        if (*value == '"') quoted = !quoted;
+        value++;
+    }
+    if (!*value) return;
+    *value++ = '\0';
+    char *params = line + strcspn(line, ";");
+    if (*params) *params++ = '\0';
+    bool date_value = strstr(params, "VALUE=DATE") && !strstr(params, "VALUE=DATE-TIME");
+
+    if (strcasecmp(line, "DTSTART") == 0) {
+        event->has_start = parse_ics_time(value, &event->start_day, &event->start_minute) > 0;
+        event->all_day = date_value || event->start_minute < 0;
+        if (event->start_minute < 0) event->start_minute = 0;
+    } else if (strcasecmp(line, "DTEND") == 0) {
+        event->has_end = parse_ics_time(value, &event->end_day, &event->end_minute) > 0;
+        if (event->end_minute < 0) event->end_minute = 0;
+    } else if (strcasecmp(line, "DURATION") == 0) {
+        event->duration = parse_duration(value);
+    } else if (strcasecmp(line, "RRULE") == 0) {
+        parse_rule(&event->rule, value);
+    } else if (strcasecmp(line, "EXDATE") == 0) {
+        for (char *save = NULL, *item = strtok_r(value, ",", &save); item; item = strtok_r(NULL, ",", &save)) {
+            long day;
+            int minute;
+            if (event->exdate_count < ICS_MAX_EXDATES && parse_ics_time(item, &day, &minute)) {
+                event->exdates[event->exdate_count++] = day;
+            }
+        }
+    } else if (strcasecmp(line, "STATUS") == 0) {
+        if (strcasecmp(value, "CANCELLED") == 0) event->inactive = true;
+    } else if (strcasecmp(line, "TRANSP") == 0) {
+        if (strcasecmp(value, "TRANSPARENT") == 0) event->inactive = true;
+    }
+}
+
+bool import_ics(MeetingScheduler *scheduler, FILE *fp, int person, IcsImportStats *stats) {
+    memset(stats, 0, sizeof(*stats));
+    if (person >= scheduler->person_grids.count) return false;
+    IcsImport *import = malloc(sizeof(IcsImport));
+    if (!import) return false;
+    import->scheduler = scheduler;
+    import->grid = person >= 0 ? person_grid(scheduler, person) : scheduler->occupancy;
+    import->fp = fp;
+    import->stats = stats;
+    bool in_event = false;
+    int nested = 0; // Depth of components inside the event, such as VALARM
+    while (next_line(import)) {
+        char *line = import->line;
+        if (strncasecmp(line, "BEGIN:", 6) == 0) {
+            if (in_event) {
+                nested++;
+            } else if (strcasecmp(line + 6, "VEVENT") == 0) {
+                in_event = true;
+                memset(&import->event, 0, offsetof(IcsEvent, exdates));
+                import->event.duration = -1;
+            }
+        } else if (strncasecmp(line, "END:", 4) == 0) {
+            if (in_event && nested > 0) {
+                nested--;
+            } else if (in_event && strcasecmp(line + 4, "VEVENT") == 0) {
+                in_event = false;
+                apply_event(import);
+            }
+        } else if (in_event && nested == 0) {
+            read_property(import, line);
+        }
+    }
+    bool ok = !ferror(fp);
+    free(import);
+    return ok;
+}
+
+bool import_ics_file(MeetingScheduler *scheduler, const char *path, int person, IcsImportStats *stats) {
+    FILE *fp = strcmp(path, "-") == 0 ? stdin : fopen(path, "r");
+    if (!fp) {
+        printf("Error: Cannot open %s\n", path);
+        return false;
+    }
+    setvbuf(fp, NULL, _IOFBF, ICS_IO_BUFFER);
+    bool ok = import_ics(scheduler, fp, person, stats);
+    if (fp != stdin) fclose(fp);
+    if (!ok) printf("Error: Failed reading %s\n", path);
+    return ok;
+}
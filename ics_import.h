@@ -0,0 +1,38 @@
+#ifndef ICS_IMPORT_H
+#define ICS_IMPORT_H
+
+#include <stdio.h>
+#include "scheduler_core.h"
+
+// Streaming iCalendar (RFC 5545) import of existing commitments.
+//
+// The file is read once, a content line at a time, with folded lines joined
+// into a fixed buffer, so memory does not grow with the file. Each VEVENT is
+// expanded from DTSTART, DTEND or DURATION, RRULE and EXDATE as soon as its
+// END:VEVENT is read, and every occurrence inside the horizon blocks the
+// slots it overlaps, like block_day does for whole days. Occurrences before
+// the horizon are skipped arithmetically where the rule allows.
+//
+// RRULE supports FREQ=DAILY, WEEKLY, MONTHLY and YEARLY with INTERVAL,
+// COUNT, UNTIL, BYDAY (with ordinals within a month), BYMONTHDAY and
+// BYMONTH; other rule parts are ignored. Times are taken as wall-clock times
+// of the scheduler's calendar: TZID and a UTC 'Z' are not converted.
+// Cancelled and TRANSP:TRANSPARENT events block nothing.
+// A RECURRENCE-ID override blocks its own time; the instance it replaces
+// stays blocked as well, since the master event may already have been applied.
+#define ICS_MAX_LINE 16384 // Longer content lines are truncated
+#define ICS_MAX_EXDATES 1024 // Per event; further EXDATEs are ignored
+
+typedef struct {
+    long events; // VEVENTs read
+    long occurrences; // Occurrences that blocked slots inside the horizon
+    long skipped; // Events that block nothing: cancelled, free, or without a usable start or rule
+} IcsImportStats;
+
+// Blocks the organiser's calendar, or one attendee's when person >= 0.
+// Returns false on a read error; malformed events are skipped and counted.
+bool import_ics(MeetingScheduler *scheduler, FILE *fp, int person, IcsImportStats *stats);
+// Same for a file name, "-" for stdin; reports failures
+bool import_ics_file(MeetingScheduler *scheduler, const char *path, int person, IcsImportStats *stats);
+
+#endif
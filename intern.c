@@ -0,0 +1,125 @@
+#include <string.h>
+#include "intern.h"
+
+#define INTERN_INITIAL_SLOTS 64
+
+static uint32_t hash_string(const char *str, size_t len) {
+    uint32_t hash = 2166136261u; // FNV-1a
+    for (size_t i = 0; i < len; i++) {
+        hash ^= (unsigned char)str[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static bool rehash(InternTable *table, uint32_t slot_count) {
+    // The old slot array is left in the arena; doubling bounds the waste
+    uint32_t *slots = arena_calloc(table->arena, slot_count * sizeof(uint32_t));
+    if (!slots) return false;
+    uint32_t mask = slot_count - 1;
+    for (int id = 0; id < table->strings.count; id++) {
+        const char *str = intern_lookup(table, (uint32_t)id);
+        uint32_t i = hash_string(str, strlen(str)) & mask;
+        while (slots[i]) i = (i + 1) & mask;
+        slots[i] = (uint32_t)id + 1;
+    }
+    table->slots = slots;
+    table->slot_mask = mask;
+    return true;
+}
+
+bool intern_init(InternTable *table, Arena *arena) {
+    table->arena = arena;
+    store_init(&table->strings, arena, sizeof(const char *));
+    table->slots = NULL;
+    return rehash(table, INTERN_INITIAL_SLOTS);
+}
+
+// Slot holding `str`, or the empty slot where it belongs
+static uint32_t probe(const InternTable *table, const char *str, size_t len) {
+    uint32_t i = hash_string(str, len) & table->slot_mask;
+    while (table->slots[i]) {
+        const char *existing = intern_lookup(table, table->slots[i] - 1);
+        if (strncmp(existing, str, len) == 0 && existing[len] == '\0') break;
+        i = (i + 1) & table->slot_mask;
+    }
+    return i;
+}
+
+uint32_t intern_find(const InternTable *table, const char *str) {
+    uint32_t i = probe(table, str, strlen(str));
+    return table->slots[i] ? table->slots[i] - 1 : INTERN_NONE;
+}
+
+uint32_t intern_string(InternTable *table, const char *str) {
+    size_t len = strlen(str);
+    uint32_t i = probe(table, str, len);
+    if (table->slots[i]) return table->slots[i] - 1;
+    // Keep the load factor under one half, growing before the insert so a
+    // failed grow leaves the table as it was
+    if ((uint32_t)(table->strings.count + 1) * 2 > table->slot_mask) {
+        if (!rehash(table, (table->slot_mask + 1) * 2)) return INTERN_NONE;
+        i = probe(table, str, len);
+    }
+    char *copy = arena_alloc(table->arena, len + 1);
+    const char **entry = copy ? store_push(&table->strings) : NULL;
+    if (!entry) return INTERN_NONE;
+    memcpy(copy, str, len + 1);
+    *entry = copy;
+    uint32_t id = (uint32_t)table->strings.count - 1;
+    table->slots[i] = id + 1;
+    return id;
+}
+
+// Empties slot i, shifting later entries of its probe run back so every
+// remaining string is still found
+static void remove_slot(InternTable *table, uint32_t i) {
+    uint32_t mask = table->slot_mask;
+    for (uint32_t j = (i + 1) & mask; table->slots[j]; j = (j + 1) & mask) {
+        const char *str = intern_lookup(table, table->slots[j] - 1);
+        uint32_t home = hash_string(str, strlen(str)) & mask;
+        // The entry may fill the hole unless its home lies between the hole and it
+        if (((j - home) & mask) >= ((j - i) & mask)) {
+            table->slots[i] = table->slots[j];
+            i = j;
+        }
+    }
+    table->slots[i] = 0;
+}
+
+void intern_drop(InternTable *table, int first, const bool *keep) {
+    int count = table->strings.count;
+    for (int id = first; id < count; id++) {
+        if (keep[id - first]) continue;
+        const char *str = intern_lookup(table, (uint32_t)id);
+        remove_slot(table, probe(table, str, strlen(str)));
+    }
+    // Ids only move down, so an entry not yet renumbered still finds its string
+    int next = first;
+    for (int id = first; id < count; id++) {
+        if (!keep[id - first]) continue;
+        if (id != next) {
+            const char *str = intern_lookup(table, (uint32_t)id);
+            table->slots[probe(table, str, strlen(str))] = (uint32_t)next + 1;
+            *(const char **)store_at(&table->strings, next) = str;
+        }
+        next++;
+    }
+    store_truncate(&table->strings, next);
+}
+
+// Rebuilds a table over strings saved elsewhere: string i starts at
+// data + offsets[i], and `slots` is the saved hash array, used in place
+bool intern_map(InternTable *table, Arena *arena, const uint32_t *offsets, const char *data, int count,
+                uint32_t *slots, uint32_t slot_count) {
+    table->arena = arena;
+    store_init(&table->strings, arena, sizeof(const char *));
+    for (int id = 0; id < count; id++) {
+        const char **entry = store_push(&table->strings);
+        if (!entry) return false;
+        *entry = data + offsets[id];
+    }
+    table->slots = slots;
+    table->slot_mask = slot_count - 1;
+    return true;
+}
@@ -0,0 +1,37 @@
+#ifndef INTERN_H
+#define INTERN_H
+
+#include <stdint.h>
+#include "arena.h"
+
+#define INTERN_NONE UINT32_MAX
+
+// String intern table: every distinct string is stored once in the arena and
+// referred to by a dense 32-bit id. Equal ids mean equal strings.
+typedef struct {
+    Arena *arena;
+    Store strings; // const char *, indexed by id
+    uint32_t *slots; // Open-addressed hash of id + 1; 0 marks an empty slot
+    uint32_t slot_mask;
+} InternTable;
+
+// Both return false / INTERN_NONE when the arena is out of memory
+bool intern_init(InternTable *table, Arena *arena);
+uint32_t intern_string(InternTable *table, const char *str);
+// Id of a string already interned, or INTERN_NONE
+uint32_t intern_find(const InternTable *table, const char *str);
+// Forgets ids from `first` on whose keep[id - first] is false and renumbers
+// the rest down in order; nothing is allocated
+void intern_drop(InternTable *table, int first, const bool *keep);
+bool intern_map(InternTable *table, Arena *arena, const uint32_t *offsets, const char *data, int count,
+                uint32_t *slots, uint32_t slot_count);
+
+static inline const char *intern_lookup(const InternTable *table, uint32_t id) {
+    return *(const char **)store_at(&table->strings, (int)id);
+}
+
+static inline int intern_count(const InternTable *table) {
+    return table->strings.count;
+}
+
+#endif
@@ -0,0 +1,315 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "libscheduler.h"
+#include "scheduler_core.h"
+#include "render.h"
+
+struct SchedulerHandle {
+    MeetingScheduler scheduler;
+};
+
+// Whole slots for a duration in minutes, or 0 when it is not schedulable
+static int duration_slots(int minutes) {
+    int length = grid_config()->slot_minutes;
+    if (minutes <= 0 || minutes > max_duration_slots() * length) return 0;
+    return (minutes + length - 1) / length;
+}
+
+// Status of an edit that did not go through. Callers clear the arena's
+// failed flag first, so a set flag means this edit ran out of memory.
+static int edit_failed(const SchedulerHandle *handle, int rejected) {
+    return handle->scheduler.arena.failed ? SCHED_ERR_MEMORY : rejected;
+}
+
+static const MeetingSeries *live_series(const SchedulerHandle *handle, int series) {
+    if (!handle || series < 0 || series >= handle->scheduler.series.count) return NULL;
+    const MeetingSeries *s = series_at(&handle->scheduler, series);
+    return s->occurrences ? s : NULL;
+}
+
+int sched_api_version(void) {
+    return SCHED_API_VERSION;
+}
+
+int sched_configure_grid(int slot_minutes, int day_start, int day_end,
+                         int break_start, int break_end, int max_meeting_minutes) {
+    GridConfig config = {slot_minutes, day_start, day_end, break_start, break_end, max_meeting_minutes};
+    // configure_grid reports bad grids; check first so the library stays quiet
+    return !check_grid_config(&config) && configure_grid(&config);
+}
+
+int sched_slot_count(void) {
+    return slot_count();
+}
+
+int sched_slot_minutes(int slot) {
+    return slot >= 0 && slot < slot_count() ? slot_minutes(slot) : -1;
+}
+
+SchedulerHandle *sched_create(int week_count, int day_count) {
+    if (week_count < 1 || week_count > MAX_HORIZON_WEEKS || day_count < 1 || day_count > MAX_DAYS) return NULL;
+    SchedulerHandle *handle = malloc(sizeof(SchedulerHandle));
+    if (!handle) return NULL;
+    if (!init_scheduler_days(&handle->scheduler, week_count, day_count)) {
+        sched_destroy(handle);
+        return NULL;
+    }
+    return handle;
+}
+
+void sched_destroy(SchedulerHandle *handle) {
+    if (!handle) return;
+    free_scheduler(&handle->scheduler);
+    free(handle);
+}
+
+void sched_seed(SchedulerHandle *handle, uint64_t seed) {
+    if (handle) seed_scheduler(&handle->scheduler, seed);
+}
+
+int sched_reserve(SchedulerHandle *handle, int day, int slot, int duration_minutes) {
+    int slots = duration_slots(duration_minutes);
+    if (!handle || day < 0 || day >= handle->scheduler.day_count || slot < 0 || slot >= slot_count() || !slots) return 0;
+    // reserve_slot_index reports clashes; check first so the library stays quiet
+    SlotMask run = run_mask(slot, slots);
+    for (int week = 0; week < handle->scheduler.week_count; week++) {
+        if (*occupancy_cell(&handle->scheduler, week, day) & run) return 0;
+    }
+    handle->scheduler.arena.failed = false;
+    return reserve_slot_index(&handle->scheduler, day, slot, slots) ? 1 : edit_failed(handle, 0);
+}
+
+int sched_block_day(SchedulerHandle *handle, int week, int day) {
+    return handle && block_day(&handle->scheduler, week, day);
+}
+
+int sched_set_start(SchedulerHandle *handle, int year, int month, int day) {
+    return handle && set_calendar_start(&handle->scheduler, year, month, day);
+}
+
+int sched_add_holiday(SchedulerHandle *handle, int year, int month, int day) {
+    if (!handle || month < 1 || month > 12 || day < 1 || day > 31) return 0;
+    return add_holiday(&handle->scheduler, year, month, day);
+}
+
+int sched_set_holiday_policy(SchedulerHandle *handle, int policy) {
+    if (!handle || (policy != SCHED_HOLIDAY_SKIP && policy != SCHED_HOLIDAY_SHIFT)) return 0;
+    handle->scheduler.holiday_policy = policy == SCHED_HOLIDAY_SHIFT ? HOLIDAY_SHIFT : HOLIDAY_SKIP;
+    return 1;
+}
+
+// Builds a Meeting from sched_add's arguments; false when they are out of range
+static bool fill_meeting(const MeetingScheduler *scheduler, Meeting *meeting, const char *name, const char *type,
+                         int duration_minutes, int frequency, int fixed_day, int fixed_slot,
+                         const int *preferred, int preferred_count) {
+    int slots = duration_slots(duration_minutes);
+    if (!name || !type || !slots || frequency < 0 || frequency >= FREQ_COUNT) return false;
+    if (fixed_day >= scheduler->day_count || fixed_slot >= slot_count()) return false;
+
+    memset(meeting, 0, sizeof(*meeting));
+    snprintf(meeting->name, MAX_STR, "%s", name);
+    snprintf(meeting->type, MAX_STR, "%s", type);
+    meeting->duration = slots;
+    meeting->frequency = frequency;
+    if (fixed_day >= 0) snprintf(meeting->fixed_day, MAX_STR, "%s", DAYS[fixed_day]);
+    if (fixed_slot >= 0) snprintf(meeting->fixed_time, MAX_STR, "%s", TIME_SLOTS[fixed_slot]);
+    int count = 0;
+    for (int i = 0; preferred && i < preferred_count && count < 8; i++) {
+        if (preferred[i] >= 0 && preferred[i] < slot_count()) meeting->preferred_hours[count++] = preferred[i];
+    }
+    if (count < 8) meeting->preferred_hours[count] = -1;
+    return true;
+}
+
+int sched_add(SchedulerHandle *handle, const char *name, const char *type,
+              int duration_minutes, int frequency, int fixed_day, int fixed_slot,
+              const int *preferred, int preferred_count) {
+    if (!handle) return -1;
+    MeetingScheduler *scheduler = &handle->scheduler;
+    Meeting meeting;
+    if (!fill_meeting(scheduler, &meeting, name, type, duration_minutes, frequency, fixed_day, fixed_slot,
+                      preferred, preferred_count)) {
+        return -1;
+    }
+    int series = scheduler->series.count;
+    scheduler->arena.failed = false;
+    return try_add_meeting(scheduler, &meeting) ? series : edit_failed(handle, -1);
+}
+
+int sched_add_batch(SchedulerHandle *handle, const SchedMeeting *meetings, int count, int *series) {
+    if (!handle || count < 0 || (count && (!meetings || !series))) return -1;
+    if (count == 0) return 0;
+    MeetingScheduler *scheduler = &handle->scheduler;
+    // Invalid requests are left out of the batch and reported as not placed
+    Meeting *valid = malloc((size_t)count * sizeof(Meeting));
+    int *index = malloc((size_t)count * sizeof(int));
+    int *placed_series = malloc((size_t)count * sizeof(int));
+    int valid_count = 0, placed = SCHED_ERR_MEMORY;
+    if (valid && index && placed_series) {
+        for (int i = 0; i < count; i++) {
+            const SchedMeeting *m = &meetings[i];
+            series[i] = -1;
+            if (fill_meeting(scheduler, &valid[valid_count], m->name, m->type, m->duration_minutes, m->frequency,
+                             m->fixed_day, m->fixed_slot, m->preferred, m->preferred_count)) {
+                index[valid_count++] = i;
+            }
+        }
+        // try_add_meetings fails only when out of memory, and still fills placed_series
+        placed = try_add_meetings(scheduler, valid, valid_count, placed_series);
+        for (int i = 0; i < valid_count; i++) series[index[i]] = placed_series[i];
+        if (placed < 0) placed = SCHED_ERR_MEMORY;
+    }
+    free(valid);
+    free(index);
+    free(placed_series);
+    return placed;
+}
+
+int sched_place(SchedulerHandle *handle, const char *name, const char *type,
+                int duration_minutes, int frequency, int day, int slot, int first_week) {
+    if (!handle || day < 0 || slot < 0) return -1;
+    MeetingScheduler *scheduler = &handle->scheduler;
+    Meeting meeting;
+    if (!fill_meeting(scheduler, &meeting, name, type, duration_minutes, frequency, day, slot, NULL, 0)) return -1;
+    if (!(allowed_starts(meeting.duration) >> slot & 1)) return -1;
+    if (first_week < 0 || first_week >= frequency_phases(frequency, scheduler->week_count)) return -1;
+    int period = frequency_period(frequency);
+    int occurrences = frequency_occurrences(frequency, scheduler->week_count);
+    SlotMask run = run_mask(slot, meeting.duration);
+    for (int k = 0; k < occurrences; k++) {
+        int week = first_week + k * period;
+        if (!is_holiday(scheduler, week, day) && (*occupancy_cell(scheduler, week, day) & run)) return -1;
+    }
+    scheduler->arena.failed = false;
+    int series = place_meeting(scheduler, &meeting, day, slot, first_week, occurrences);
+    return series >= 0 ? series : SCHED_ERR_MEMORY;
+}
+
+int sched_free_slots(const SchedulerHandle *handle, int duration_minutes, int frequency,
+                     int fixed_day, int fixed_slot, const int *preferred, int preferred_count,
+                     SchedSlot *out, int capacity) {
+    if (!handle || capacity < 0 || (capacity && !out)) return -1;
+    const MeetingScheduler *scheduler = &handle->scheduler;
+    Meeting meeting;
+    if (!fill_meeting(scheduler, &meeting, "", "", duration_minutes, frequency, fixed_day, fixed_slot,
+                      preferred, preferred_count)) {
+        return -1;
+    }
+    // No more than one per day and start can exist
+    FreeSlot found[MAX_DAYS * MAX_SLOTS];
+    int max = capacity < MAX_DAYS * MAX_SLOTS ? capacity : MAX_DAYS * MAX_SLOTS;
+    int count = find_free_slots(scheduler, &meeting, found, max);
+    for (int i = 0; i < count; i++) {
+        out[i] = (SchedSlot){found[i].day, found[i].start_time, slot_minutes(found[i].start_time), found[i].phase,
+                             found[i].occurrences, (int32_t)(found[i].day_hours * 60 + 0.5)};
+    }
+    return count;
+}
+
+int sched_remove(SchedulerHandle *handle, int series) {
+    // remove_meeting reports unknown series; check first so the library stays quiet
+    return live_series(handle, series) && remove_meeting(&handle->scheduler, series);
+}
+
+int sched_series_count(const SchedulerHandle *handle) {
+    return handle ? handle->scheduler.series.count : 0;
+}
+
+const char *sched_series_name(const SchedulerHandle *handle, int series) {
+    const MeetingSeries *s = live_series(handle, series);
+    return s ? scheduler_string(&handle->scheduler, s->name) : NULL;
+}
+
+const char *sched_series_type(const SchedulerHandle *handle, int series) {
+    const MeetingSeries *s = live_series(handle, series);
+    return s ? scheduler_string(&handle->scheduler, s->type) : NULL;
+}
+
+int sched_occurrence_count(const SchedulerHandle *handle) {
+    return sched_occurrences(handle, NULL, 0);
+}
+
+int sched_occurrences(const SchedulerHandle *handle, SchedOccurrence *out, int capacity) {
+    return handle ? sched_occurrences_between(handle, 0, handle->scheduler.week_count * 7 - 1, out, capacity) : 0;
+}
+
+int sched_occurrences_between(const SchedulerHandle *handle, int first_day, int last_day,
+                              SchedOccurrence *out, int capacity) {
+    if (!handle) return 0;
+    const MeetingScheduler *scheduler = &handle->scheduler;
+    RangeIter it;
+    Occurrence occ;
+    occurrences_between(scheduler, scheduler->start_date + first_day, scheduler->start_date + last_day, &it);
+    int total = 0;
+    for (; next_in_range(&it, &occ); total++) {
+        if (total >= capacity) continue;
+        out[total] = (SchedOccurrence){occ.series, occ.week, occ.day, slot_minutes(occ.start_time),
+                                       slots_to_minutes(occ.duration)};
+    }
+    return total;
+}
+
+int sched_series_clash(const SchedulerHandle *handle, int a, int b) {
+    const MeetingSeries *first = live_series(handle, a), *second = live_series(handle, b);
+    return first && second && a != b ? series_clash(&handle->scheduler, first, second) : -1;
+}
+
+long sched_format_schedule(const SchedulerHandle *handle, int format, char **out) {
+    if (!handle || !out || format < 0 || format >= SCHEDULE_FORMAT_COUNT) return -1;
+    *out = NULL;
+    OutBuf text;
+    outbuf_init(&text, NULL, 64 * 1024);
+    if (text.failed || !format_schedule(&handle->scheduler, (ScheduleFormat)format, &text)) {
+        outbuf_free(&text);
+        return -1;
+    }
+    *out = text.data;
+    return (long)text.len;
+}
+
+int sched_export_ics(SchedulerHandle *handle, const char *path) {
+    if (!handle || !path) return 0;
+    FILE *fp = fopen(path, "w");
+    if (!fp) return 0;
+    bool ok = sched_write_ics(handle, fp);
+    return fclose(fp) == 0 && ok;
+}
+
+int sched_write_ics(const SchedulerHandle *handle, FILE *fp) {
+    return handle && fp && write_ics(&handle->scheduler, fp);
+}
+
+long sched_render_month(const char *title, int weeks, const SchedCell *cells,
+                        const SchedEvent *events, int event_count,
+                        int day_start, int day_end, int bar_minutes, int format, char **out) {
+    if (!out || !cells || weeks < 1 || weeks > RENDER_MAX_WEEKS || event_count < 0 || (event_count && !events)) return -1;
+    *out = NULL;
+    int cell_count = weeks * 7;
+    RenderCell *render_cells = malloc(cell_count * sizeof(RenderCell));
+    RenderEvent *render_events = malloc((event_count ? event_count : 1) * sizeof(RenderEvent));
+    OutBuf image;
+    outbuf_init(&image, NULL, 64 * 1024);
+    bool ok = render_cells && render_events && !image.failed;
+    if (ok) {
+        for (int i = 0; i < cell_count; i++) render_cells[i] = (RenderCell){cells[i].number, cells[i].fill, cells[i].note};
+        for (int i = 0; i < event_count; i++) {
+            const SchedEvent *e = &events[i];
+            render_events[i] = (RenderEvent){e->cell, e->start_minutes, e->duration_minutes, e->fill, e->text, e->label};
+        }
+        MonthView view = {title, weeks, render_cells, render_events, event_count, day_start, day_end, bar_minutes};
+        ok = format == SCHED_RENDER_PNG ? render_png(&view, &image) : render_svg(&view, &image);
+    }
+    free(render_cells);
+    free(render_events);
+    if (!ok) {
+        outbuf_free(&image);
+        return -1;
+    }
+    *out = image.data;
+    return (long)image.len;
+}
+
+void sched_free(void *buffer) {
+    free(buffer);
+}
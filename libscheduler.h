@@ -0,0 +1,171 @@
+#ifndef LIBSCHEDULER_H
+#define LIBSCHEDULER_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+// C API of libscheduler.so, for callers outside this tree (see scheduler_lib.py).
+//
+// A SchedulerHandle owns one MeetingScheduler. Days are indexes from Monday,
+// slots index the working half hours (sched_slot_minutes gives their start)
+// and durations are in minutes, rounded up to whole slots. Functions return
+// -1 or 0 on bad arguments and never print; only the symbols below are
+// exported from the library.
+#if defined(__GNUC__)
+#define SCHED_API __attribute__((visibility("default")))
+#else
+#define SCHED_API
+#endif
+
+#define SCHED_API_VERSION 9
+
+// Returned by the calls that store data when memory ran out; the scheduler
+// is left as it was before the call
+#define SCHED_ERR_MEMORY -2
+
+typedef struct SchedulerHandle SchedulerHandle;
+
+// One placed occurrence, as returned by sched_occurrences
+typedef struct {
+    int32_t series; // Value returned by sched_add
+    int32_t week;
+    int32_t day;
+    int32_t start_minutes; // Minutes after midnight
+    int32_t duration_minutes;
+} SchedOccurrence;
+
+// One meeting request of a batch, with the arguments of sched_add
+typedef struct {
+    const char *name;
+    const char *type;
+    int32_t duration_minutes;
+    int32_t frequency;
+    int32_t fixed_day;
+    int32_t fixed_slot;
+    int32_t preferred[8];
+    int32_t preferred_count;
+} SchedMeeting;
+
+// One placement suggested by sched_free_slots
+typedef struct {
+    int32_t day;
+    int32_t slot;
+    int32_t start_minutes; // Minutes after midnight
+    int32_t first_week; // Week of the first occurrence
+    int32_t occurrences; // Occurrences on this day, after holidays
+    int32_t day_minutes; // Meetings and reservations on the day over the horizon, once placed
+} SchedSlot;
+
+SCHED_API int sched_api_version(void);
+// Sets the process-wide time grid (see GridConfig), in minutes since midnight.
+// Call it before sched_create; 1 when the grid is usable.
+SCHED_API int sched_configure_grid(int slot_minutes, int day_start, int day_end,
+                                   int break_start, int break_end, int max_meeting_minutes);
+SCHED_API int sched_slot_count(void);
+// Start of a slot in minutes after midnight, or -1
+SCHED_API int sched_slot_minutes(int slot);
+
+// NULL when week_count or day_count is out of range, or out of memory
+SCHED_API SchedulerHandle *sched_create(int week_count, int day_count);
+SCHED_API void sched_destroy(SchedulerHandle *handle);
+SCHED_API void sched_seed(SchedulerHandle *handle, uint64_t seed);
+
+// Blocks a slot run on `day` in every week; 1 on success, 0 on a clash or bad
+// arguments, or SCHED_ERR_MEMORY
+SCHED_API int sched_reserve(SchedulerHandle *handle, int day, int slot, int duration_minutes);
+// Blocks every slot of one (week, day), e.g. for days outside the month; 1 on success
+SCHED_API int sched_block_day(SchedulerHandle *handle, int week, int day);
+
+// Week 0 starts on the Monday on or before the given date (2025-04-14 by
+// default); it drops any holidays already added. 1 on success.
+SCHED_API int sched_set_start(SchedulerHandle *handle, int year, int month, int day);
+// Marks a date as a holiday; 1 when it lies within the horizon
+SCHED_API int sched_add_holiday(SchedulerHandle *handle, int year, int month, int day);
+#define SCHED_HOLIDAY_SKIP 0 // Occurrences on a holiday are dropped
+#define SCHED_HOLIDAY_SHIFT 1 // ... or moved to the next free working day of that week
+SCHED_API int sched_set_holiday_policy(SchedulerHandle *handle, int policy);
+
+// Places a meeting series the way add_meeting does and returns its series
+// index, -1 when it does not fit, or SCHED_ERR_MEMORY. frequency is 0 weekly, 1 fortnightly,
+// 2 every third week, 3 monthly. fixed_day and fixed_slot are -1 for any;
+// `preferred` lists up to 8 slots to try first, in order.
+SCHED_API int sched_add(SchedulerHandle *handle, const char *name, const char *type,
+                        int duration_minutes, int frequency, int fixed_day, int fixed_slot,
+                        const int *preferred, int preferred_count);
+// Places a whole set the way add_meetings does, least flexible first rather
+// than in list order. series[i] receives meeting i's series index, or -1 when
+// it did not fit or is invalid. Returns the number placed, -1 for bad
+// arguments, or SCHED_ERR_MEMORY, in which case series[] still shows the
+// meetings placed before memory ran out.
+SCHED_API int sched_add_batch(SchedulerHandle *handle, const SchedMeeting *meetings, int count, int *series);
+// Records a series at a known day, slot and first week, as sched_add placed
+// it before, e.g. to rebuild a cached calendar without searching again.
+// Returns its series index, -1 when a slot is taken or an argument is bad,
+// or SCHED_ERR_MEMORY.
+SCHED_API int sched_place(SchedulerHandle *handle, const char *name, const char *type,
+                          int duration_minutes, int frequency, int day, int slot, int first_week);
+SCHED_API int sched_remove(SchedulerHandle *handle, int series);
+// Read-only: up to `capacity` placements sched_add could make for these
+// arguments, with the day left least loaded first. Nothing is placed, so it
+// is cheap enough to call as a form is being filled in. Returns how many were
+// written, or -1 for bad arguments.
+SCHED_API int sched_free_slots(const SchedulerHandle *handle, int duration_minutes, int frequency,
+                               int fixed_day, int fixed_slot, const int *preferred, int preferred_count,
+                               SchedSlot *out, int capacity);
+
+SCHED_API int sched_series_count(const SchedulerHandle *handle);
+SCHED_API const char *sched_series_name(const SchedulerHandle *handle, int series);
+SCHED_API const char *sched_series_type(const SchedulerHandle *handle, int series);
+SCHED_API int sched_occurrence_count(const SchedulerHandle *handle);
+// Copies up to `capacity` occurrences, series by series, and returns the total
+// available, so a call with capacity 0 sizes the buffer
+SCHED_API int sched_occurrences(const SchedulerHandle *handle, SchedOccurrence *out, int capacity);
+// Same for the occurrences on days first_day .. last_day, counted from the
+// Monday of week 0; series are expanded only over the weeks in range
+SCHED_API int sched_occurrences_between(const SchedulerHandle *handle, int first_day, int last_day,
+                                        SchedOccurrence *out, int capacity);
+// First week in which two series take overlapping slots of the same day, or -1
+SCHED_API int sched_series_clash(const SchedulerHandle *handle, int a, int b);
+
+// 1 when the file was written
+SCHED_API int sched_export_ics(SchedulerHandle *handle, const char *path);
+// Writes the ICS calendar to an open stream; 1 on success
+SCHED_API int sched_write_ics(const SchedulerHandle *handle, FILE *fp);
+
+#define SCHED_FORMAT_TEXT 0 // The week by week listing of the scheduler's --display
+#define SCHED_FORMAT_JSON 1
+#define SCHED_FORMAT_CSV 2 // One line per occurrence, under a header line
+// Formats the whole schedule (see ScheduleFormat in scheduler_core.h) and
+// returns its size, the text being stored in *out to be released with
+// sched_free, or -1.
+SCHED_API long sched_format_schedule(const SchedulerHandle *handle, int format, char **out);
+
+// Month view for sched_render_month: `weeks` rows of Monday-first day cells
+// with timed bars drawn in them. Colours are 0xRRGGBB.
+typedef struct {
+    int32_t number; // Day of the month printed in the corner, or 0
+    uint32_t fill;
+    const char *note; // Printed along the bottom edge, or NULL
+} SchedCell;
+
+typedef struct {
+    int32_t cell; // week * 7 + weekday
+    int32_t start_minutes; // Minutes after midnight
+    int32_t duration_minutes;
+    uint32_t fill;
+    uint32_t text;
+    const char *label;
+} SchedEvent;
+
+#define SCHED_RENDER_SVG 0
+#define SCHED_RENDER_PNG 1
+
+// Renders a month view as SVG or PNG. Cells span day_start to day_end, and
+// bars are bar_minutes tall, or their own duration when it is 0. Returns the
+// size of the image stored in *out, to be released with sched_free, or -1.
+SCHED_API long sched_render_month(const char *title, int weeks, const SchedCell *cells,
+                                  const SchedEvent *events, int event_count,
+                                  int day_start, int day_end, int bar_minutes, int format, char **out);
+SCHED_API void sched_free(void *buffer);
+
+#endif
@@ -0,0 +1,66 @@
+#include <stdlib.h>
+#include "outbuf.h"
+
+void outbuf_init(OutBuf *out, FILE *fp, size_t capacity) {
+    out->fp = fp;
+    out->cap = capacity ? capacity : OUTBUF_DEFAULT_CAPACITY;
+    out->data = malloc(out->cap);
+    out->len = 0;
+    out->failed = out->data == NULL;
+}
+
+// Makes room for `extra` more bytes: flush to the file, or grow in memory
+void outbuf_reserve(OutBuf *out, size_t extra) {
+    if (out->failed) return;
+    if (out->fp) {
+        outbuf_flush(out);
+        if (extra <= out->cap) return;
+    }
+    size_t cap = out->cap;
+    while (out->len + extra > cap) cap *= 2;
+    char *data = realloc(out->data, cap);
+    if (!data) {
+        out->failed = true;
+        return;
+    }
+    out->data = data;
+    out->cap = cap;
+}
+
+bool outbuf_flush(OutBuf *out) {
+    if (out->fp && out->len) {
+        if (fwrite(out->data, 1, out->len, out->fp) != out->len) out->failed = true;
+        out->len = 0;
+    }
+    return !out->failed;
+}
+
+void outbuf_free(OutBuf *out) {
+    free(out->data);
+    out->data = NULL;
+    out->len = out->cap = 0;
+}
+
+void outbuf_int(OutBuf *out, long value) {
+    char digits[24];
+    int n = 0;
+    unsigned long v = value < 0 ? 0UL - (unsigned long)value : (unsigned long)value;
+    do {
+        digits[n++] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v);
+    if (value < 0) digits[n++] = '-';
+    if (out->len + n > out->cap) outbuf_reserve(out, n);
+    if (out->failed) return;
+    while (n) out->data[out->len++] = digits[--n];
+}
+
+void outbuf_digits(OutBuf *out, unsigned value, int width) {
+    if (out->len + width > out->cap) outbuf_reserve(out, width);
+    if (out->failed) return;
+    for (int i = width - 1; i >= 0; i--) {
+        out->data[out->len + i] = (char)('0' + value % 10);
+        value /= 10;
+    }
+    out->len += width;
+}
@@ -0,0 +1,46 @@
+#ifndef OUTBUF_H
+#define OUTBUF_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#define OUTBUF_DEFAULT_CAPACITY (1 << 20)
+
+// Output accumulated in one large buffer. With a FILE it is flushed with a
+// single fwrite whenever it fills up; without one it grows and keeps
+// everything in memory for the caller.
+typedef struct {
+    FILE *fp;
+    char *data;
+    size_t len;
+    size_t cap;
+    bool failed; // Allocation or write error
+} OutBuf;
+
+void outbuf_init(OutBuf *out, FILE *fp, size_t capacity);
+void outbuf_reserve(OutBuf *out, size_t extra);
+bool outbuf_flush(OutBuf *out);
+void outbuf_free(OutBuf *out);
+void outbuf_int(OutBuf *out, long value);
+void outbuf_digits(OutBuf *out, unsigned value, int width); // Zero-padded to width
+
+static inline void outbuf_write(OutBuf *out, const char *data, size_t len) {
+    if (out->len + len > out->cap) outbuf_reserve(out, len);
+    if (out->failed) return;
+    memcpy(out->data + out->len, data, len);
+    out->len += len;
+}
+
+static inline void outbuf_puts(OutBuf *out, const char *str) {
+    outbuf_write(out, str, strlen(str));
+}
+
+static inline void outbuf_char(OutBuf *out, char c) {
+    if (out->len + 1 > out->cap) outbuf_reserve(out, 1);
+    if (out->failed) return;
+    out->data[out->len++] = c;
+}
+
+#endif
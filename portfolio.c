@@ -0,0 +1,144 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "portfolio.h"
+
+typedef struct {
+    uint64_t seed;
+    int placed;
+    double total_spread;
+    double meeting_spread;
+} Attempt;
+
+typedef struct {
+    const MeetingScheduler *base;
+    const Meeting *meetings;
+    int count;
+    const PortfolioOptions *options;
+    pthread_mutex_t lock; // Guards next and best
+    int next;
+    Attempt best;
+    bool have_best;
+} Portfolio;
+
+static double spread(const double *hours, int day_count, int week_count) {
+    double low = hours[0], high = hours[0];
+    for (int d = 1; d < day_count; d++) {
+        if (hours[d] < low) low = hours[d];
+        if (hours[d] > high) high = hours[d];
+    }
+    return (high - low) / week_count;
+}
+
+static bool better_attempt(const Attempt *a, const Attempt *b) {
+    if (a->placed != b->placed) return a->placed > b->placed;
+    if (a->total_spread != b->total_spread) return a->total_spread < b->total_spread;
+    if (a->meeting_spread != b->meeting_spread) return a->meeting_spread < b->meeting_spread;
+    return a->seed < b->seed;
+}
+
+// Reservations are copied by index, so the base scheduler is only read.
+// People are added in the same order, so meeting attendee indexes still apply.
+// The start date and holidays come along too; reset_scheduler drops holidays.
+// Slots blocked without a reservation, by block_day or an ICS import, come
+// with the base occupancy. Meetings the base already holds are not copied as
+// series, but their slots come with the grids and their hours with the day
+// totals, so the daily cap and day load order match the final replay. False
+// when out of memory.
+static bool copy_reservations(MeetingScheduler *dst, const MeetingScheduler *src) {
+    dst->start_date = src->start_date;
+    dst->holiday_policy = src->holiday_policy;
+    dst->holiday_count = src->holiday_count;
+    memcpy(dst->holidays, src->holidays, src->week_count);
+    for (int i = 0; i < src->reservations.count; i++) {
+        const Reservation *res = reservation_at(src, i);
+        if (!reserve_slot_index(dst, res->day, res->start_time, res->duration)) return false;
+    }
+    size_t grid_size = (size_t)src->week_count * MAX_DAYS * sizeof(SlotMask);
+    memcpy(dst->occupancy, src->occupancy, grid_size);
+    for (int person = 0; person < src->person_grids.count; person++) {
+        if (add_person(dst, intern_lookup(&src->people, person)) < 0) return false;
+        memcpy(person_grid(dst, person), person_grid(src, person), grid_size);
+    }
+    memcpy(dst->total_hours, src->total_hours, sizeof(dst->total_hours));
+    memcpy(dst->meeting_hours, src->meeting_hours, sizeof(dst->meeting_hours));
+    memcpy(dst->load_order, src->load_order, sizeof(dst->load_order));
+    return true;
+}
+
+static void *portfolio_worker(void *arg) {
+    Portfolio *portfolio = arg;
+    MeetingScheduler scheduler;
+    bool ready = init_scheduler_days(&scheduler, portfolio->base->week_count, portfolio->base->day_count);
+    // A worker that runs out of memory stops; its attempt is dropped rather than scored
+    while (ready) {
+        pthread_mutex_lock(&portfolio->lock);
+        int i = portfolio->next++;
+        pthread_mutex_unlock(&portfolio->lock);
+        if (i >= portfolio->options->attempts) break;
+
+        Attempt attempt = {portfolio->options->first_seed + (uint64_t)i, 0, 0, 0};
+        scheduler.arena.failed = false;
+        if (!reset_scheduler(&scheduler) || !copy_reservations(&scheduler, portfolio->base)) break;
+        seed_scheduler(&scheduler, attempt.seed);
+        for (int m = 0; m < portfolio->count; m++) {
+            if (try_add_meeting(&scheduler, &portfolio->meetings[m])) attempt.placed++;
+        }
+        if (scheduler.arena.failed) break;
+        attempt.total_spread = spread(scheduler.total_hours, scheduler.day_count, scheduler.week_count);
+        attempt.meeting_spread = spread(scheduler.meeting_hours, scheduler.day_count, scheduler.week_count);
+
+        pthread_mutex_lock(&portfolio->lock);
+        if (!portfolio->have_best || better_attempt(&attempt, &portfolio->best)) {
+            portfolio->best = attempt;
+            portfolio->have_best = true;
+        }
+        pthread_mutex_unlock(&portfolio->lock);
+    }
+    free_scheduler(&scheduler);
+    return NULL;
+}
+
+bool run_portfolio(MeetingScheduler *scheduler, const Meeting *meetings, int count,
+                   const PortfolioOptions *options, PortfolioResult *result) {
+    Portfolio portfolio = {scheduler, meetings, count, options, PTHREAD_MUTEX_INITIALIZER, 0, {0}, false};
+    int threads = options->threads;
+    if (threads <= 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cpus > 0 ? (int)cpus : 1;
+    }
+    if (threads > options->attempts) threads = options->attempts > 0 ? options->attempts : 1;
+
+    pthread_t *workers = malloc(threads * sizeof(pthread_t));
+    int started = 0;
+    while (workers && started < threads &&
+           pthread_create(&workers[started], NULL, portfolio_worker, &portfolio) == 0) {
+        started++;
+    }
+    if (started == 0) portfolio_worker(&portfolio); // No threads available: run inline
+    for (int t = 0; t < started; t++) pthread_join(workers[t], NULL);
+    free(workers);
+    pthread_mutex_destroy(&portfolio.lock);
+
+    result->threads = started > 0 ? started : 1;
+    if (!portfolio.have_best) {
+        printf("Error: No portfolio attempts were run\n");
+        result->attempts = 0;
+        return false;
+    }
+    result->attempts = options->attempts;
+    result->seed = portfolio.best.seed;
+    result->placed = portfolio.best.placed;
+    result->total_spread = portfolio.best.total_spread;
+    result->meeting_spread = portfolio.best.meeting_spread;
+
+    // Replay the winner; add_meeting reports whatever it could not place
+    seed_scheduler(scheduler, result->seed);
+    bool ok = true;
+    for (int m = 0; m < count; m++) {
+        if (!add_meeting(scheduler, &meetings[m])) ok = false;
+    }
+    return ok;
+}
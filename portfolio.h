@@ -0,0 +1,38 @@
+#ifndef PORTFOLIO_H
+#define PORTFOLIO_H
+
+#include "scheduler_core.h"
+
+// Randomized restarts of the greedy add_meeting pass.
+//
+// Attempt i runs the whole meeting list, in order, on a private scheduler
+// holding the base scheduler's reservations and seeded with first_seed + i.
+// Workers share nothing but the attempt counter and the best result, so the
+// portfolio scales with the number of threads. The winner places the most
+// meetings, then has the smallest spread of total_hours across days, then
+// of meeting_hours; remaining ties go to the lower seed, so the choice does
+// not depend on thread timing, and a one-attempt portfolio started at the
+// winning seed reproduces the same schedule.
+typedef struct {
+    int attempts;
+    int threads; // 0 = one per online CPU
+    uint64_t first_seed;
+} PortfolioOptions;
+
+typedef struct {
+    uint64_t seed; // Winning seed
+    int placed; // Meetings placed by the winner
+    double total_spread; // Max - min total_hours per week across days
+    double meeting_spread; // Same for meeting_hours
+    int attempts;
+    int threads;
+} PortfolioResult;
+
+// Replays the winning attempt into `scheduler` (which must hold only the
+// reservations) and returns true when it placed every meeting. When no
+// attempt could run it returns false with result->attempts set to 0 and the
+// winner's fields untouched.
+bool run_portfolio(MeetingScheduler *scheduler, const Meeting *meetings, int count,
+                   const PortfolioOptions *options, PortfolioResult *result);
+
+#endif
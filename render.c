@@ -0,0 +1,512 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "render.h"
+
+// Layout in pixels, shared by both formats
+#define COLUMNS 7
+#define LEFT 64 // Week labels
+#define TOP 56 // Title and weekday labels
+#define CELL_W 160
+#define CELL_H 180
+#define CELL_HEADER 20 // Day number strip above the bars
+#define PAD 12
+
+#define WHITE 0xffffff
+#define BLACK 0x000000
+#define NOTE_COLOR 0x8b0000
+
+static const char *WEEKDAY_LABELS[COLUMNS] = {"Mon", "Tue", "Wed", "Thu", "Fri", "Sat", "Sun"};
+
+static bool valid_view(const MonthView *view) {
+    return view->weeks >= 1 && view->weeks <= RENDER_MAX_WEEKS && view->cells &&
+           view->day_end > view->day_start && (view->events || !view->event_count);
+}
+
+static int view_width(void) {
+    return LEFT + COLUMNS * CELL_W + PAD;
+}
+
+static int view_height(const MonthView *view) {
+    return TOP + view->weeks * CELL_H + PAD;
+}
+
+static int cell_x(int cell) {
+    return LEFT + cell % COLUMNS * CELL_W;
+}
+
+static int cell_y(int cell) {
+    return TOP + cell / COLUMNS * CELL_H;
+}
+
+// Vertical extent of an event's bar inside its cell, below the day number;
+// false when it is not drawn
+static bool event_bar(const MonthView *view, const RenderEvent *event, int *top, int *height) {
+    if (event->cell < 0 || event->cell >= view->weeks * COLUMNS) return false;
+    int span = view->day_end - view->day_start;
+    int minutes = view->bar_minutes > 0 ? view->bar_minutes : event->duration_minutes;
+    int start = event->start_minutes - view->day_start;
+    if (start < 0) start = 0;
+    if (start >= span) start = span - 1;
+    int body = CELL_H - CELL_HEADER;
+    *top = CELL_HEADER + start * body / span;
+    *height = minutes * body / span;
+    if (*height < 1) *height = 1;
+    if (*top + *height > CELL_H) *height = CELL_H - *top;
+    return true;
+}
+
+// --- SVG ---
+
+static void svg_attr_int(OutBuf *out, const char *name, long value) {
+    outbuf_char(out, ' ');
+    outbuf_puts(out, name);
+    outbuf_puts(out, "=\"");
+    outbuf_int(out, value);
+    outbuf_char(out, '"');
+}
+
+static void svg_color(OutBuf *out, const char *name, uint32_t rgb) {
+    static const char HEX[] = "0123456789abcdef";
+    char color[7];
+    for (int i = 0; i < 6; i++) color[i] = HEX[(rgb >> (20 - 4 * i)) & 0xf];
+    color[6] = '\0';
+    outbuf_char(out, ' ');
+    outbuf_puts(out, name);
+    outbuf_puts(out, "=\"#");
+    outbuf_puts(out, color);
+    outbuf_char(out, '"');
+}
+
+static void svg_escaped(OutBuf *out, const char *text) {
+    for (const char *p = text; *p; p++) {
+        switch (*p) {
+        case '&': outbuf_puts(out, "&amp;"); break;
+        case '<': outbuf_puts(out, "&lt;"); break;
+        case '>': outbuf_puts(out, "&gt;"); break;
+        case '"': outbuf_puts(out, "&quot;"); break;
+        default: outbuf_char(out, *p);
+        }
+    }
+}
+
+// `attrs` is written verbatim after the position
+static void svg_text(OutBuf *out, int x, int y, const char *attrs, const char *text) {
+    outbuf_puts(out, "<text");
+    svg_attr_int(out, "x", x);
+    svg_attr_int(out, "y", y);
+    outbuf_puts(out, attrs);
+    outbuf_char(out, '>');
+    svg_escaped(out, text);
+    outbuf_puts(out, "</text>\n");
+}
+
+static void svg_rect(OutBuf *out, int x, int y, int width, int height, uint32_t fill, const char *stroke) {
+    outbuf_puts(out, "<rect");
+    svg_attr_int(out, "x", x);
+    svg_attr_int(out, "y", y);
+    svg_attr_int(out, "width", width);
+    svg_attr_int(out, "height", height);
+    svg_color(out, "fill", fill);
+    outbuf_puts(out, stroke);
+    outbuf_puts(out, "/>\n");
+}
+
+bool render_svg(const MonthView *view, OutBuf *out) {
+    if (!valid_view(view)) return false;
+    int width = view_width(), height = view_height(view);
+    outbuf_puts(out, "<svg xmlns=\"http://www.w3.org/2000/svg\" viewBox=\"0 0 ");
+    outbuf_int(out, width);
+    outbuf_char(out, ' ');
+    outbuf_int(out, height);
+    outbuf_char(out, '"');
+    svg_attr_int(out, "width", width);
+    svg_attr_int(out, "height", height);
+    outbuf_puts(out, " font-family=\"sans-serif\">\n");
+    svg_rect(out, 0, 0, width, height, WHITE, "");
+    if (view->title) svg_text(out, width / 2, 28, " text-anchor=\"middle\" font-size=\"18\"", view->title);
+    for (int d = 0; d < COLUMNS; d++) {
+        svg_text(out, cell_x(d) + CELL_W / 2, TOP - 8, " text-anchor=\"middle\" font-size=\"13\"", WEEKDAY_LABELS[d]);
+    }
+
+    char label[16];
+    for (int cell = 0; cell < view->weeks * COLUMNS; cell++) {
+        const RenderCell *c = &view->cells[cell];
+        int x = cell_x(cell), y = cell_y(cell);
+        if (cell % COLUMNS == 0) {
+            snprintf(label, sizeof(label), "Week %d", cell / COLUMNS + 1);
+            svg_text(out, LEFT - 8, y + CELL_H / 2, " text-anchor=\"end\" font-size=\"13\"", label);
+        }
+        svg_rect(out, x, y, CELL_W, CELL_H, c->fill, " stroke=\"#000\"");
+        if (c->note) {
+            svg_text(out, x + CELL_W / 2, y + CELL_H - 4, " text-anchor=\"middle\" font-size=\"9\" fill=\"#8b0000\"",
+                     c->note);
+        }
+    }
+
+    // A nested <svg> per bar clips its label to the bar
+    for (int i = 0; i < view->event_count; i++) {
+        const RenderEvent *event = &view->events[i];
+        int top, bar_height;
+        if (!event_bar(view, event, &top, &bar_height)) continue;
+        outbuf_puts(out, "<svg");
+        svg_attr_int(out, "x", cell_x(event->cell));
+        svg_attr_int(out, "y", cell_y(event->cell) + top);
+        svg_attr_int(out, "width", CELL_W);
+        svg_attr_int(out, "height", bar_height);
+        outbuf_puts(out, "><rect width=\"100%\" height=\"100%\"");
+        svg_color(out, "fill", event->fill);
+        outbuf_puts(out, " stroke=\"#000\" stroke-width=\"0.5\"/><text x=\"50%\" y=\"50%\" text-anchor=\"middle\" "
+                         "dominant-baseline=\"central\" font-size=\"8\"");
+        svg_color(out, "fill", event->text);
+        outbuf_char(out, '>');
+        if (event->label) svg_escaped(out, event->label);
+        outbuf_puts(out, "</text></svg>\n");
+    }
+
+    for (int cell = 0; cell < view->weeks * COLUMNS; cell++) {
+        if (!view->cells[cell].number) continue;
+        snprintf(label, sizeof(label), "%d", view->cells[cell].number);
+        svg_text(out, cell_x(cell) + 4, cell_y(cell) + 14, " font-size=\"12\" font-weight=\"bold\"", label);
+    }
+    outbuf_puts(out, "</svg>\n");
+    return outbuf_flush(out);
+}
+
+// --- PNG ---
+
+// 5x7 glyphs for ' ' to '~', one byte per column with the top row in bit 0
+static const unsigned char FONT[95][5] = {
+    {0x00, 0x00, 0x00, 0x00, 0x00}, {0x00, 0x00, 0x5f, 0x00, 0x00}, {0x00, 0x07, 0x00, 0x07, 0x00},
+    {0x14, 0x7f, 0x14, 0x7f, 0x14}, {0x24, 0x2a, 0x7f, 0x2a, 0x12}, {0x23, 0x13, 0x08, 0x64, 0x62},
+    {0x36, 0x49, 0x55, 0x22, 0x50}, {0x00, 0x05, 0x03, 0x00, 0x00}, {0x00, 0x1c, 0x22, 0x41, 0x00},
+    {0x00, 0x41, 0x22, 0x1c, 0x00}, {0x14, 0x08, 0x3e, 0x08, 0x14}, {0x08, 0x08, 0x3e, 0x08, 0x08},
+    {0x00, 0x50, 0x30, 0x00, 0x00}, {0x08, 0x08, 0x08, 0x08, 0x08}, {0x00, 0x60, 0x60, 0x00, 0x00},
+    {0x20, 0x10, 0x08, 0x04, 0x02}, {0x3e, 0x51, 0x49, 0x45, 0x3e}, {0x00, 0x42, 0x7f, 0x40, 0x00},
+    {0x42, 0x61, 0x51, 0x49, 0x46}, {0x21, 0x41, 0x45, 0x4b, 0x31}, {0x18, 0x14, 0x12, 0x7f, 0x10},
+    {0x27, 0x45, 0x45, 0x45, 0x39}, {0x3c, 0x4a, 0x49, 0x49, 0x30}, {0x01, 0x71, 0x09, 0x05, 0x03},
+    {0x36, 0x49, 0x49, 0x49, 0x36}, {0x06, 0x49, 0x49, 0x29, 0x1e}, {0x00, 0x36, 0x36, 0x00, 0x00},
+    {0x00, 0x56, 0x36, 0x00, 0x00}, {0x08, 0x14, 0x22, 0x41, 0x00}, {0x14, 0x14, 0x14, 0x14, 0x14},
+    {0x00, 0x41, 0x22, 0x14, 0x08}, {0x02, 0x01, 0x51, 0x09, 0x06}, {0x32, 0x49, 0x79, 0x41, 0x3e},
+    {0x7e, 0x11, 0x11, 0x11, 0x7e}, {0x7f, 0x49, 0x49, 0x49, 0x36}, {0x3e, 0x41, 0x41, 0x41, 0x22},
+    {0x7f, 0x41, 0x41, 0x22, 0x1c}, {0x7f, 0x49, 0x49, 0x49, 0x41}, {0x7f, 0x09, 0x09, 0x09, 0x01},
+    {0x3e, 0x41, 0x49, 0x49, 0x7a}, {0x7f, 0x08, 0x08, 0x08, 0x7f}, {0x00, 0x41, 0x7f, 0x41, 0x00},
+    {0x20, 0x40, 0x41, 0x3f, 0x01}, {0x7f, 0x08, 0x14, 0x22, 0x41}, {0x7f, 0x40, 0x40, 0x40, 0x40},
+    {0x7f, 0x02, 0x0c, 0x02, 0x7f}, {0x7f, 0x04, 0x08, 0x10, 0x7f}, {0x3e, 0x41, 0x41, 0x41, 0x3e},
+    {0x7f, 0x09, 0x09, 0x09, 0x06}, {0x3e, 0x41, 0x51, 0x21, 0x5e}, {0x7f, 0x09, 0x19, 0x29, 0x46},
+    {0x46, 0x49, 0x49, 0x49, 0x31}, {0x01, 0x01, 0x7f, 0x01, 0x01}, {0x3f, 0x40, 0x40, 0x40, 0x3f},
+    {0x1f, 0x20, 0x40, 0x20, 0x1f}, {0x3f, 0x40, 0x38, 0x40, 0x3f}, {0x63, 0x14, 0x08, 0x14, 0x63},
+    {0x07, 0x08, 0x70, 0x08, 0x07}, {0x61, 0x51, 0x49, 0x45, 0x43}, {0x00, 0x7f, 0x41, 0x41, 0x00},
+    {0x02, 0x04, 0x08, 0x10, 0x20}, {0x00, 0x41, 0x41, 0x7f, 0x00}, {0x04, 0x02, 0x01, 0x02, 0x04},
+    {0x40, 0x40, 0x40, 0x40, 0x40}, {0x00, 0x01, 0x02, 0x04, 0x00}, {0x20, 0x54, 0x54, 0x54, 0x78},
+    {0x7f, 0x48, 0x44, 0x44, 0x38}, {0x38, 0x44, 0x44, 0x44, 0x20}, {0x38, 0x44, 0x44, 0x48, 0x7f},
+    {0x38, 0x54, 0x54, 0x54, 0x18}, {0x08, 0x7e, 0x09, 0x01, 0x02}, {0x0c, 0x52, 0x52, 0x52, 0x3e},
+    {0x7f, 0x08, 0x04, 0x04, 0x78}, {0x00, 0x44, 0x7d, 0x40, 0x00}, {0x20, 0x40, 0x44, 0x3d, 0x00},
+    {0x7f, 0x10, 0x28, 0x44, 0x00}, {0x00, 0x41, 0x7f, 0x40, 0x00}, {0x7c, 0x04, 0x18, 0x04, 0x78},
+    {0x7c, 0x08, 0x04, 0x04, 0x78}, {0x38, 0x44, 0x44, 0x44, 0x38}, {0x7c, 0x14, 0x14, 0x14, 0x08},
+    {0x08, 0x14, 0x14, 0x18, 0x7c}, {0x7c, 0x08, 0x04, 0x04, 0x08}, {0x48, 0x54, 0x54, 0x54, 0x20},
+    {0x04, 0x3f, 0x44, 0x40, 0x20}, {0x3c, 0x40, 0x40, 0x20, 0x7c}, {0x1c, 0x20, 0x40, 0x20, 0x1c},
+    {0x3c, 0x40, 0x30, 0x40, 0x3c}, {0x44, 0x28, 0x10, 0x28, 0x44}, {0x0c, 0x50, 0x50, 0x50, 0x3c},
+    {0x44, 0x64, 0x54, 0x4c, 0x44}, {0x00, 0x08, 0x36, 0x41, 0x00}, {0x00, 0x00, 0x7f, 0x00, 0x00},
+    {0x00, 0x41, 0x36, 0x08, 0x00}, {0x08, 0x04, 0x08, 0x10, 0x08},
+};
+
+#define GLYPH_ADVANCE 6 // Five columns and a space
+
+typedef enum {
+    ALIGN_LEFT,
+    ALIGN_CENTER,
+    ALIGN_RIGHT
+} Align;
+
+typedef struct {
+    int width;
+    int height;
+    unsigned char *pixels; // Palette indexes, row by row
+    uint32_t palette[256];
+    int colors;
+} Raster;
+
+// Palette index of a colour, adding it while there is room and otherwise
+// falling back to the nearest entry
+static unsigned char palette_index(Raster *raster, uint32_t rgb) {
+    for (int i = 0; i < raster->colors; i++) {
+        if (raster->palette[i] == rgb) return (unsigned char)i;
+    }
+    if (raster->colors < 256) {
+        raster->palette[raster->colors] = rgb;
+        return (unsigned char)raster->colors++;
+    }
+    int best = 0;
+    long best_distance = -1;
+    for (int i = 0; i < raster->colors; i++) {
+        long distance = 0;
+        for (int shift = 0; shift < 24; shift += 8) {
+            long delta = (long)((rgb >> shift) & 0xff) - (long)((raster->palette[i] >> shift) & 0xff);
+            distance += delta * delta;
+        }
+        if (best_distance < 0 || distance < best_distance) {
+            best = i;
+            best_distance = distance;
+        }
+    }
+    return (unsigned char)best;
+}
+
+static void fill_rect(Raster *raster, int x, int y, int width, int height, uint32_t rgb) {
+    int x0 = x < 0 ? 0 : x, y0 = y < 0 ? 0 : y;
+    int x1 = x + width > raster->width ? raster->width : x + width;
+    int y1 = y + height > raster->height ? raster->height : y + height;
+    if (x0 >= x1 || y0 >= y1) return;
+    unsigned char index = palette_index(raster, rgb);
+    for (int row = y0; row < y1; row++) memset(raster->pixels + (size_t)row * raster->width + x0, index, x1 - x0);
+}
+
+static void frame_rect(Raster *raster, int x, int y, int width, int height, uint32_t rgb) {
+    fill_rect(raster, x, y, width, 1, rgb);
+    fill_rect(raster, x, y + height - 1, width, 1, rgb);
+    fill_rect(raster, x, y, 1, height, rgb);
+    fill_rect(raster, x + width - 1, y, 1, height, rgb);
+}
+
+// Next glyph of a UTF-8 string; dashes and quotes map to ASCII, other
+// characters outside it to '?'
+static int next_glyph(const char **text) {
+    const unsigned char *p = (const unsigned char *)*text;
+    int c = *p++;
+    if (c >= 0x80) {
+        int code = 0, extra = c >= 0xf0 ? 3 : c >= 0xe0 ? 2 : c >= 0xc0 ? 1 : 0;
+        code = c & (0x3f >> extra);
+        for (; extra && (*p & 0xc0) == 0x80; extra--) code = code << 6 | (*p++ & 0x3f);
+        c = code == 0x2013 || code == 0x2014 ? '-' : code == 0x2018 || code == 0x2019 ? '\'' : '?';
+    } else if (c < ' ' || c > '~') {
+        c = '?';
+    }
+    *text = (const char *)p;
+    return c;
+}
+
+static int text_width(const char *text, int scale) {
+    int glyphs = 0;
+    while (*text) {
+        next_glyph(&text);
+        glyphs++;
+    }
+    return glyphs ? glyphs * GLYPH_ADVANCE * scale - scale : 0;
+}
+
+// Draws `text` with its top at y, aligned on x and clipped to [clip_x0, clip_x1).
+// Text wider than the clip starts at its left edge.
+static void draw_text(Raster *raster, int x, int y, const char *text, uint32_t rgb, int scale, Align align,
+                      int clip_x0, int clip_x1) {
+    int width = text_width(text, scale);
+    if (align == ALIGN_CENTER) x -= width / 2;
+    if (align == ALIGN_RIGHT) x -= width;
+    if (width > clip_x1 - clip_x0) x = clip_x0 + 1;
+    if (clip_x0 < 0) clip_x0 = 0;
+    if (clip_x1 > raster->width) clip_x1 = raster->width;
+    unsigned char index = palette_index(raster, rgb);
+    while (*text && x < clip_x1) {
+        const unsigned char *glyph = FONT[next_glyph(&text) - ' '];
+        for (int col = 0; col < 5 * scale; col++) {
+            int px = x + col;
+            if (px < clip_x0 || px >= clip_x1) continue;
+            for (int row = 0; row < 7 * scale; row++) {
+                int py = y + row;
+                if (py >= 0 && py < raster->height && glyph[col / scale] >> (row / scale) & 1) {
+                    raster->pixels[(size_t)py * raster->width + px] = index;
+                }
+            }
+        }
+        x += GLYPH_ADVANCE * scale;
+    }
+}
+
+static void rasterize(const MonthView *view, Raster *raster) {
+    palette_index(raster, WHITE); // Index 0, the zero-filled background
+    draw_text(raster, raster->width / 2, 14, view->title ? view->title : "", BLACK, 2, ALIGN_CENTER, 0, raster->width);
+    for (int d = 0; d < COLUMNS; d++) {
+        draw_text(raster, cell_x(d) + CELL_W / 2, TOP - 16, WEEKDAY_LABELS[d], BLACK, 1, ALIGN_CENTER, 0, raster->width);
+    }
+
+    char label[16];
+    for (int cell = 0; cell < view->weeks * COLUMNS; cell++) {
+        const RenderCell *c = &view->cells[cell];
+        int x = cell_x(cell), y = cell_y(cell);
+        if (cell % COLUMNS == 0) {
+            snprintf(label, sizeof(label), "Week %d", cell / COLUMNS + 1);
+            draw_text(raster, LEFT - 8, y + CELL_H / 2 - 4, label, BLACK, 1, ALIGN_RIGHT, 0, LEFT);
+        }
+        fill_rect(raster, x, y, CELL_W, CELL_H, c->fill);
+        frame_rect(raster, x, y, CELL_W + 1, CELL_H + 1, BLACK);
+        if (c->note) {
+            draw_text(raster, x + CELL_W / 2, y + CELL_H - 10, c->note, NOTE_COLOR, 1, ALIGN_CENTER, x, x + CELL_W);
+        }
+    }
+
+    for (int i = 0; i < view->event_count; i++) {
+        const RenderEvent *event = &view->events[i];
+        int top, height;
+        if (!event_bar(view, event, &top, &height)) continue;
+        int x = cell_x(event->cell), y = cell_y(event->cell) + top;
+        fill_rect(raster, x, y, CELL_W + 1, height, event->fill);
+        frame_rect(raster, x, y, CELL_W + 1, height, BLACK);
+        if (event->label && height >= 9) {
+            draw_text(raster, x + CELL_W / 2, y + (height - 7) / 2, event->label, event->text, 1, ALIGN_CENTER,
+                      x + 1, x + CELL_W);
+        }
+    }
+
+    for (int cell = 0; cell < view->weeks * COLUMNS; cell++) {
+        if (!view->cells[cell].number) continue;
+        snprintf(label, sizeof(label), "%d", view->cells[cell].number);
+        draw_text(raster, cell_x(cell) + 4, cell_y(cell) + 4, label, BLACK, 2, ALIGN_LEFT, 0, raster->width);
+    }
+}
+
+static uint32_t crc32_update(uint32_t crc, const unsigned char *data, size_t len) {
+    crc = ~crc;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (int k = 0; k < 8; k++) crc = crc >> 1 ^ (0xedb88320u & (0u - (crc & 1)));
+    }
+    return ~crc;
+}
+
+static void put_be32(OutBuf *out, uint32_t value) {
+    char bytes[4] = {(char)(value >> 24), (char)(value >> 16), (char)(value >> 8), (char)value};
+    outbuf_write(out, bytes, sizeof(bytes));
+}
+
+static void put_chunk(OutBuf *out, const char *type, const unsigned char *data, size_t len) {
+    put_be32(out, (uint32_t)len);
+    outbuf_write(out, type, 4);
+    outbuf_write(out, (const char *)data, len);
+    put_be32(out, crc32_update(crc32_update(0, (const unsigned char *)type, 4), data, len));
+}
+
+// Deflate with the fixed Huffman codes, where the only matches are runs of
+// the previous byte (distance 1). Flat-colour rows under the Up filter are
+// mostly zeros, so this gets close to zlib's ratio at a fraction of the code.
+typedef struct {
+    OutBuf *out;
+    uint32_t bits;
+    int count;
+} BitWriter;
+
+static void put_bits(BitWriter *w, uint32_t value, int n) {
+    w->bits |= value << w->count;
+    w->count += n;
+    while (w->count >= 8) {
+        outbuf_char(w->out, (char)(w->bits & 0xff));
+        w->bits >>= 8;
+        w->count -= 8;
+    }
+}
+
+// Huffman codes are stored most significant bit first
+static void put_code(BitWriter *w, uint32_t code, int n) {
+    uint32_t reversed = 0;
+    for (int i = 0; i < n; i++) reversed |= (code >> i & 1) << (n - 1 - i);
+    put_bits(w, reversed, n);
+}
+
+static void put_symbol(BitWriter *w, int symbol) {
+    if (symbol < 144) put_code(w, 0x30 + symbol, 8);
+    else if (symbol < 256) put_code(w, 0x190 + symbol - 144, 9);
+    else if (symbol < 280) put_code(w, symbol - 256, 7);
+    else put_code(w, 0xc0 + symbol - 280, 8);
+}
+
+static const int LENGTH_BASE[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+static const int LENGTH_EXTRA[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                     3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+
+static void put_run(BitWriter *w, int length) {
+    int code = 28;
+    while (LENGTH_BASE[code] > length) code--;
+    put_symbol(w, 257 + code);
+    put_bits(w, (uint32_t)(length - LENGTH_BASE[code]), LENGTH_EXTRA[code]);
+    put_code(w, 0, 5); // Distance 1
+}
+
+static void deflate_runs(const unsigned char *data, size_t len, OutBuf *out) {
+    BitWriter w = {out, 0, 0};
+    put_bits(&w, 1, 1); // Final block
+    put_bits(&w, 1, 2); // Fixed codes
+    size_t i = 0;
+    while (i < len) {
+        size_t run = 0;
+        while (i > 0 && i + run < len && run < 258 && data[i + run] == data[i - 1]) run++;
+        if (run >= 3) {
+            put_run(&w, (int)run);
+            i += run;
+        } else {
+            put_symbol(&w, data[i++]);
+        }
+    }
+    put_symbol(&w, 256);
+    if (w.count) put_bits(&w, 0, 8 - w.count);
+}
+
+bool render_png(const MonthView *view, OutBuf *out) {
+    if (!valid_view(view)) return false;
+    Raster raster = {view_width(), view_height(view), NULL, {0}, 0};
+    size_t stride = (size_t)raster.width + 1; // Filter byte per row
+    raster.pixels = calloc((size_t)raster.width * raster.height, 1);
+    unsigned char *filtered = malloc(stride * raster.height);
+    OutBuf idat;
+    outbuf_init(&idat, NULL, 64 * 1024);
+    bool ok = raster.pixels && filtered && !idat.failed;
+    if (ok) {
+        rasterize(view, &raster);
+        // Up filter on every row but the first: identical rows become zeros
+        for (int y = 0; y < raster.height; y++) {
+            unsigned char *row = filtered + y * stride;
+            const unsigned char *pixels = raster.pixels + (size_t)y * raster.width;
+            row[0] = y ? 2 : 0;
+            for (int x = 0; x < raster.width; x++) row[1 + x] = y ? pixels[x] - pixels[x - raster.width] : pixels[x];
+        }
+        // Adler-32, reduced every 5552 bytes as in zlib so the sums cannot overflow
+        uint32_t a = 1, b = 0;
+        size_t len = stride * raster.height;
+        for (size_t k = 0; k < len;) {
+            size_t end = k + 5552 < len ? k + 5552 : len;
+            for (; k < end; k++) {
+                a += filtered[k];
+                b += a;
+            }
+            a %= 65521;
+            b %= 65521;
+        }
+        outbuf_char(&idat, 0x78); // zlib header: deflate, 32 KiB window
+        outbuf_char(&idat, 0x01);
+        deflate_runs(filtered, stride * raster.height, &idat);
+        put_be32(&idat, b << 16 | a);
+        ok = !idat.failed;
+    }
+    if (ok) {
+        unsigned char header[13] = {0};
+        uint32_t size[2] = {(uint32_t)raster.width, (uint32_t)raster.height};
+        for (int i = 0; i < 8; i++) header[i] = (unsigned char)(size[i / 4] >> (24 - 8 * (i % 4)));
+        header[8] = 8; // Bit depth
+        header[9] = 3; // Indexed colour
+        unsigned char palette[256 * 3];
+        for (int i = 0; i < raster.colors; i++) {
+            palette[3 * i] = (unsigned char)(raster.palette[i] >> 16);
+            palette[3 * i + 1] = (unsigned char)(raster.palette[i] >> 8);
+            palette[3 * i + 2] = (unsigned char)raster.palette[i];
+        }
+        outbuf_write(out, "\x89PNG\r\n\x1a\n", 8);
+        put_chunk(out, "IHDR", header, sizeof(header));
+        put_chunk(out, "PLTE", palette, (size_t)raster.colors * 3);
+        put_chunk(out, "IDAT", (const unsigned char *)idat.data, idat.len);
+        put_chunk(out, "IEND", (const unsigned char *)"", 0);
+        ok = outbuf_flush(out);
+    }
+    free(raster.pixels);
+    free(filtered);
+    outbuf_free(&idat);
+    return ok;
+}
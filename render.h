@@ -0,0 +1,45 @@
+#ifndef RENDER_H
+#define RENDER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "outbuf.h"
+
+// Month view renderer: a grid of weeks by Monday-first weekdays, with
+// timed meeting bars drawn inside the day cells. It writes SVG directly,
+// or rasterizes the same layout into an indexed-colour PNG with a built-in
+// 5x7 pixel font. Colours are 0xRRGGBB.
+typedef struct {
+    int number; // Day of the month printed in the corner; 0 prints nothing
+    uint32_t fill;
+    const char *note; // Drawn along the bottom edge (e.g. a holiday); may be NULL
+} RenderCell;
+
+typedef struct {
+    int cell; // Index into the cells, week * 7 + weekday
+    int start_minutes; // Minutes after midnight
+    int duration_minutes;
+    uint32_t fill;
+    uint32_t text;
+    const char *label;
+} RenderEvent;
+
+typedef struct {
+    const char *title;
+    int weeks;
+    const RenderCell *cells; // weeks * 7
+    const RenderEvent *events;
+    int event_count;
+    int day_start; // Minutes after midnight at the top of a cell
+    int day_end; // ... and at the bottom
+    int bar_minutes; // Height of every bar, or 0 to draw each event's duration
+} MonthView;
+
+#define RENDER_MAX_WEEKS 53
+
+// Both return false for an unusable view (events outside the cells are
+// skipped) or when the output cannot be allocated or written.
+bool render_svg(const MonthView *view, OutBuf *out);
+bool render_png(const MonthView *view, OutBuf *out);
+
+#endif
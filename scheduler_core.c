@@ -0,0 +1,1780 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <sys/mman.h>
+#include "scheduler_core.h"
+#include "outbuf.h"
+#include "dates.h"
+#include "stats.h"
+
+// Week 0 of a new scheduler starts on Monday 2025-04-14
+#define DEFAULT_START_YEAR 2025
+#define DEFAULT_START_MONTH 4
+#define DEFAULT_START_DAY 14
+
+// Constants
+const char *DAYS[MAX_DAYS] = {"Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday", "Sunday"};
+const char *FREQUENCIES[FREQ_COUNT] = {"weekly", "fortnightly", "third_week", "monthly"};
+static const int FREQUENCY_PERIODS[FREQ_COUNT] = {1, 2, 3, 4}; // Weeks between occurrences
+const int DURATIONS[3] = {30, 60, 90};
+const char *SCHEDULE_FORMATS[SCHEDULE_FORMAT_COUNT] = {"text", "json", "csv"};
+
+// Time grid. configure_grid rebuilds every table below once, so the hot
+// paths only index arrays.
+static GridConfig grid = {30, 9 * 60, 17 * 60, 12 * 60, 13 * 60, 90};
+static int grid_slots; // Slots per day
+static int grid_max_duration; // Longest meeting in slots
+static int start_minutes[MAX_SLOTS]; // Minutes since midnight per slot
+static char slot_labels[MAX_SLOTS][6];
+static char end_labels[MAX_SLOTS][MAX_DURATION + 1][6]; // "HH:MM" end of a run, by start slot and length
+const char *TIME_SLOTS[MAX_SLOTS];
+// Bit s of start_masks[d] is set when a d-slot meeting may start at slot s:
+// the run stays inside the day, skips no break and ends by day_end
+static SlotMask start_masks[MAX_DURATION + 1];
+static bool tables_ready = false;
+
+static int parse_minutes(const char *time) {
+    if (strlen(time) != 5 || time[2] != ':') return -1;
+    return ((time[0] - '0') * 10 + (time[1] - '0')) * 60 + (time[3] - '0') * 10 + (time[4] - '0');
+}
+
+// "HH:MM" for a time of day
+static void format_minutes(char *out, int minutes) {
+    out[0] = (char)('0' + minutes / 600);
+    out[1] = (char)('0' + minutes / 60 % 10);
+    out[2] = ':';
+    out[3] = (char)('0' + minutes % 60 / 10);
+    out[4] = (char)('0' + minutes % 10);
+    out[5] = '\0';
+}
+
+// Slot starts of a grid, in order; returns how many there are (possibly more than fit)
+static int grid_starts(const GridConfig *config, int *minutes, int capacity) {
+    int count = 0;
+    for (int t = config->day_start; t + config->slot_minutes <= config->day_end; t += config->slot_minutes) {
+        if (t < config->break_end && t + config->slot_minutes > config->break_start) continue;
+        if (count < capacity) minutes[count] = t;
+        count++;
+    }
+    return count;
+}
+
+static void init_slot_tables(void) {
+    if (tables_ready) return;
+    int *minutes = start_minutes;
+    grid_slots = grid_starts(&grid, minutes, MAX_SLOTS);
+    grid_max_duration = grid.max_meeting_minutes / grid.slot_minutes;
+    for (int i = 0; i < MAX_SLOTS; i++) {
+        TIME_SLOTS[i] = NULL;
+        if (i >= grid_slots) continue;
+        format_minutes(slot_labels[i], minutes[i]);
+        TIME_SLOTS[i] = slot_labels[i];
+        for (int d = 0; d <= MAX_DURATION; d++) format_minutes(end_labels[i][d], minutes[i] + d * grid.slot_minutes);
+    }
+    for (int d = 1; d <= MAX_DURATION; d++) {
+        SlotMask mask = 0;
+        for (int s = 0; d <= grid_max_duration && s + d <= grid_slots; s++) {
+            bool ok = minutes[s] + d * grid.slot_minutes <= grid.day_end;
+            for (int i = 1; i < d && ok; i++) {
+                ok = minutes[s + i] == minutes[s] + i * grid.slot_minutes;
+            }
+            if (ok) mask |= (SlotMask)1 << s;
+        }
+        start_masks[d] = mask;
+    }
+    tables_ready = true;
+}
+
+const char *check_grid_config(const GridConfig *config) {
+    if (config->slot_minutes < 1 || config->slot_minutes > 24 * 60) return "slot length must be 1 to 1440 minutes";
+    if (config->day_start < 0 || config->day_end > 24 * 60 || config->day_start >= config->day_end) {
+        return "working day must start before it ends, within 00:00-24:00";
+    }
+    if (config->break_start > config->break_end) return "break must start before it ends";
+    if (config->max_meeting_minutes % config->slot_minutes != 0 ||
+        config->max_meeting_minutes / config->slot_minutes < 1 ||
+        config->max_meeting_minutes / config->slot_minutes > MAX_DURATION) {
+        return "longest meeting must be 1 to 16 whole slots";
+    }
+    int count = grid_starts(config, NULL, 0);
+    if (count < 1 || count > MAX_SLOTS) return "working day must hold 1 to 64 slots";
+    return NULL;
+}
+
+bool configure_grid(const GridConfig *config) {
+    const char *error = check_grid_config(config);
+    if (error) {
+        printf("Error: Invalid time grid: %s\n", error);
+        return false;
+    }
+    grid = *config;
+    tables_ready = false;
+    init_slot_tables();
+    return true;
+}
+
+// Updates `config` from "slot=15,start=08:30,end=17:00,break=12:00-13:00,max=90";
+// a bare number is the slot length. The result is not checked.
+bool parse_grid_config(const char *spec, GridConfig *config) {
+    char buffer[256];
+    if (strlen(spec) >= sizeof(buffer)) return false;
+    strcpy(buffer, spec);
+    for (char *save = NULL, *field = strtok_r(buffer, ",", &save); field; field = strtok_r(NULL, ",", &save)) {
+        char *value = strchr(field, '=');
+        if (!value) {
+            value = field;
+            field = "slot";
+        } else {
+            *value++ = '\0';
+        }
+        if (strcmp(field, "slot") == 0) {
+            config->slot_minutes = atoi(value);
+        } else if (strcmp(field, "max") == 0) {
+            config->max_meeting_minutes = atoi(value);
+        } else if (strcmp(field, "start") == 0) {
+            config->day_start = parse_minutes(value);
+        } else if (strcmp(field, "end") == 0) {
+            config->day_end = parse_minutes(value);
+        } else if (strcmp(field, "break") == 0) {
+            char *dash = strchr(value, '-');
+            if (dash) *dash++ = '\0';
+            config->break_start = parse_minutes(value);
+            config->break_end = dash ? parse_minutes(dash) : config->break_start;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+const GridConfig *grid_config(void) {
+    init_slot_tables();
+    return &grid;
+}
+
+int slot_count(void) {
+    init_slot_tables();
+    return grid_slots;
+}
+
+int max_duration_slots(void) {
+    init_slot_tables();
+    return grid_max_duration;
+}
+
+int minutes_to_slots(int minutes) {
+    init_slot_tables();
+    if (minutes <= 0 || minutes % grid.slot_minutes != 0) return 0;
+    int slots = minutes / grid.slot_minutes;
+    return slots <= grid_max_duration ? slots : 0;
+}
+
+int slots_to_minutes(int duration_slots) {
+    return duration_slots * grid.slot_minutes;
+}
+
+double duration_hours(int duration_slots) {
+    return duration_slots * grid.slot_minutes / 60.0;
+}
+
+// Utility functions
+int find_slot_index(const char *time) {
+    init_slot_tables();
+    for (int i = 0; i < grid_slots; i++) {
+        if (strcmp(TIME_SLOTS[i], time) == 0) return i;
+    }
+    return -1;
+}
+
+int find_day_index(const char *day) {
+    for (int i = 0; i < MAX_DAYS; i++) {
+        if (strcmp(DAYS[i], day) == 0) return i;
+    }
+    return -1;
+}
+
+bool is_break_slot(const char *time) {
+    int minutes = parse_minutes(time);
+    return minutes >= grid.break_start && minutes < grid.break_end;
+}
+
+double slot_to_hour(int slot_idx) {
+    return slot_minutes(slot_idx) / 60.0;
+}
+
+int slot_minutes(int slot_idx) {
+    init_slot_tables();
+    return start_minutes[slot_idx];
+}
+
+void compute_end_time(int start_idx, int duration_slots, char *end_time) {
+    memcpy(end_time, slot_end_label(start_idx, duration_slots), 6);
+}
+
+// "HH:MM" end of a run of duration_slots from a start slot, from the slot tables
+const char *slot_end_label(int start_idx, int duration_slots) {
+    init_slot_tables();
+    return end_labels[start_idx][duration_slots >= 0 && duration_slots <= MAX_DURATION ? duration_slots : 0];
+}
+
+// Frequency for a FREQUENCIES name, or -1
+int parse_frequency(const char *frequency) {
+    for (int i = 0; i < FREQ_COUNT; i++) {
+        if (strcmp(FREQUENCIES[i], frequency) == 0) return i;
+    }
+    return -1;
+}
+
+int frequency_period(Frequency frequency) {
+    return FREQUENCY_PERIODS[frequency];
+}
+
+// Occurrences within a horizon; over the default 4-week cycle this gives 4/2/1/1
+int frequency_occurrences(Frequency frequency, int week_count) {
+    int occurrences = week_count / frequency_period(frequency);
+    return occurrences > 0 ? occurrences : 1;
+}
+
+// First weeks a rule can start in with its last occurrence inside the horizon
+int frequency_phases(Frequency frequency, int week_count) {
+    return week_count - (frequency_occurrences(frequency, week_count) - 1) * frequency_period(frequency);
+}
+
+// Occupancy masks
+SlotMask allowed_starts(int duration_slots) {
+    if (duration_slots < 1 || duration_slots > MAX_DURATION) return 0;
+    init_slot_tables();
+    return start_masks[duration_slots];
+}
+
+// Slots of the grid that overlap [from_minutes, to_minutes) of a day
+SlotMask slots_overlapping(int from_minutes, int to_minutes) {
+    init_slot_tables();
+    SlotMask mask = 0;
+    for (int s = 0; s < grid_slots; s++) {
+        if (start_minutes[s] < to_minutes && start_minutes[s] + grid.slot_minutes > from_minutes) {
+            mask |= (SlotMask)1 << s;
+        }
+    }
+    return mask;
+}
+
+// Starts where duration_slots consecutive slots are clear of `busy`. Runs
+// are doubled rather than grown a slot at a time, so 15-minute grids with
+// their longer meetings take no more steps than 30-minute ones.
+static SlotMask starts_clear_of(SlotMask busy, int duration_slots) {
+    SlotMask run = ~busy; // Bit s: `span` slots from s are free
+    int span = 1;
+    while (span * 2 <= duration_slots) {
+        run &= run >> span;
+        span *= 2;
+    }
+    if (span < duration_slots) run &= run >> (duration_slots - span);
+    return run & allowed_starts(duration_slots);
+}
+
+// Starts where duration_slots consecutive slots are free in the given week/day
+SlotMask free_starts(const MeetingScheduler *scheduler, int week, int day_idx, int duration_slots) {
+    return starts_clear_of(*occupancy_cell(scheduler, week, day_idx), duration_slots);
+}
+
+// Links a reservation into its day's list; its reservation_next entry has
+// already been pushed
+static void index_reservation(MeetingScheduler *scheduler, int res_idx) {
+    const Reservation *res = reservation_at(scheduler, res_idx);
+    int *link = &scheduler->reservation_head[res->day];
+    while (*link >= 0 && reservation_at(scheduler, *link)->start_time <= res->start_time) {
+        link = store_at(&scheduler->reservation_next, *link);
+    }
+    *(int *)store_at(&scheduler->reservation_next, res_idx) = *link;
+    *link = res_idx;
+}
+
+// Initialize scheduler; false when out of memory, in which case it still
+// needs free_scheduler
+bool init_scheduler(MeetingScheduler *scheduler) {
+    return init_scheduler_horizon(scheduler, DEFAULT_WEEKS);
+}
+
+bool init_scheduler_horizon(MeetingScheduler *scheduler, int week_count) {
+    return init_scheduler_days(scheduler, week_count, DEFAULT_DAYS);
+}
+
+bool init_scheduler_days(MeetingScheduler *scheduler, int week_count, int day_count) {
+    init_slot_tables();
+    scheduler->day_count = day_count > 0 && day_count <= MAX_DAYS ? day_count : DEFAULT_DAYS;
+    arena_init(&scheduler->arena, SCHEDULER_ARENA_BLOCK);
+    scheduler->mapping = NULL;
+    scheduler->mapping_size = 0;
+    if (week_count <= 0) week_count = DEFAULT_WEEKS;
+    scheduler->week_count = week_count < MAX_HORIZON_WEEKS ? week_count : MAX_HORIZON_WEEKS;
+    scheduler->start_date = days_from_civil(DEFAULT_START_YEAR, DEFAULT_START_MONTH, DEFAULT_START_DAY);
+    scheduler->holiday_policy = HOLIDAY_SKIP;
+    seed_scheduler(scheduler, 0);
+    return reset_scheduler(scheduler);
+}
+
+// Seeds the generator behind add_meeting's week and tie-break choices, so a
+// run is reproducible from its seed. reset_scheduler leaves it alone.
+void seed_scheduler(MeetingScheduler *scheduler, uint64_t seed) {
+    scheduler->seed = seed;
+    scheduler->rng_state = seed;
+}
+
+// splitmix64, reduced to [0, bound)
+uint32_t scheduler_random(MeetingScheduler *scheduler, uint32_t bound) {
+    uint64_t z = (scheduler->rng_state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    z ^= z >> 31;
+    return (uint32_t)(((z >> 32) * bound) >> 32);
+}
+
+// Rebuilds load_order from total_hours, e.g. after a snapshot load
+void sort_day_loads(MeetingScheduler *scheduler) {
+    for (int d = 0; d < scheduler->day_count; d++) {
+        int i = d;
+        while (i > 0 && scheduler->total_hours[scheduler->load_order[i - 1]] > scheduler->total_hours[d]) {
+            scheduler->load_order[i] = scheduler->load_order[i - 1];
+            i--;
+        }
+        scheduler->load_order[i] = (uint8_t)d;
+    }
+}
+
+// Moves a day whose total_hours just changed to its new place in
+// load_order, which is usually a step or two
+static void day_load_changed(MeetingScheduler *scheduler, int day_idx) {
+    const double *total = scheduler->total_hours;
+    uint8_t *order = scheduler->load_order;
+    int i = 0;
+    while (order[i] != day_idx) i++;
+    while (i > 0 && total[order[i - 1]] > total[day_idx]) {
+        order[i] = order[i - 1];
+        i--;
+    }
+    while (i + 1 < scheduler->day_count && total[order[i + 1]] < total[day_idx]) {
+        order[i] = order[i + 1];
+        i++;
+    }
+    order[i] = (uint8_t)day_idx;
+}
+
+// Drop all reservations and meetings in one go; arena blocks are kept for
+// reuse. False when out of memory, leaving the scheduler unusable until a
+// reset succeeds.
+bool reset_scheduler(MeetingScheduler *scheduler) {
+    arena_reset(&scheduler->arena);
+    store_init(&scheduler->series, &scheduler->arena, sizeof(MeetingSeries));
+    store_init(&scheduler->exceptions, &scheduler->arena, sizeof(SeriesException));
+    store_init(&scheduler->reservations, &scheduler->arena, sizeof(Reservation));
+    store_init(&scheduler->reservation_next, &scheduler->arena, sizeof(int));
+    bool ok = intern_init(&scheduler->strings, &scheduler->arena);
+    scheduler->reserved_name = ok ? intern_string(&scheduler->strings, "Reserved (External)") : INTERN_NONE;
+    scheduler->reserved_type = ok ? intern_string(&scheduler->strings, "reserved") : INTERN_NONE;
+    memset(scheduler->total_hours, 0, sizeof(scheduler->total_hours));
+    memset(scheduler->meeting_hours, 0, sizeof(scheduler->meeting_hours));
+    sort_day_loads(scheduler);
+    int weeks = scheduler->week_count;
+    scheduler->occupancy = arena_calloc(&scheduler->arena, (size_t)weeks * MAX_DAYS * sizeof(SlotMask));
+    for (int d = 0; d < MAX_DAYS; d++) scheduler->reservation_head[d] = -1;
+    scheduler->week_starts = arena_alloc(&scheduler->arena, weeks * sizeof(SlotMask));
+    scheduler->holidays = arena_calloc(&scheduler->arena, weeks);
+    scheduler->holiday_count = 0;
+    scheduler->busy = arena_alloc(&scheduler->arena, (size_t)weeks * MAX_DAYS * sizeof(SlotMask));
+    ok = intern_init(&scheduler->people, &scheduler->arena) && ok;
+    store_init(&scheduler->person_grids, &scheduler->arena, sizeof(SlotMask *));
+    store_init(&scheduler->attendee_pool, &scheduler->arena, sizeof(int));
+    return ok && scheduler->reserved_name != INTERN_NONE && scheduler->reserved_type != INTERN_NONE &&
+           scheduler->occupancy && scheduler->week_starts && scheduler->holidays && scheduler->busy;
+}
+
+void free_scheduler(MeetingScheduler *scheduler) {
+    arena_free(&scheduler->arena);
+    if (scheduler->mapping) munmap(scheduler->mapping, scheduler->mapping_size);
+    scheduler->mapping = NULL;
+}
+
+// Person index for a name, registering the person with an empty calendar;
+// -1 when out of memory
+int add_person(MeetingScheduler *scheduler, const char *name) {
+    uint32_t known = intern_find(&scheduler->people, name);
+    if (known != INTERN_NONE) return (int)known;
+    // The grid comes first so a name is never registered without one
+    size_t cells = (size_t)scheduler->week_count * MAX_DAYS;
+    int person = scheduler->person_grids.count;
+    SlotMask *grid = arena_calloc(&scheduler->arena, cells * sizeof(SlotMask));
+    SlotMask **entry = grid ? store_push(&scheduler->person_grids) : NULL;
+    if (!entry) return -1;
+    if (intern_string(&scheduler->people, name) == INTERN_NONE) {
+        store_truncate(&scheduler->person_grids, person);
+        return -1;
+    }
+    *entry = grid;
+    return person;
+}
+
+// Blocks a slot in one person's calendar in every week; the organiser's
+// calendar is untouched
+bool reserve_person_slot(MeetingScheduler *scheduler, int person, int day_idx, int start_idx, int duration_slots) {
+    if (person < 0 || person >= scheduler->person_grids.count || day_idx < 0 || day_idx >= scheduler->day_count ||
+        start_idx < 0 || !(allowed_starts(duration_slots) >> start_idx & 1)) {
+        printf("Error: Invalid reservation for attendee %d\n", person);
+        return false;
+    }
+    SlotMask run = run_mask(start_idx, duration_slots);
+    for (int week = 0; week < scheduler->week_count; week++) {
+        person_grid(scheduler, person)[(size_t)week * MAX_DAYS + day_idx] |= run;
+    }
+    return true;
+}
+
+// Unregisters the people from index `first` on who have nothing booked and
+// are no series' attendee, renumbering the rest down, so attendees added for
+// meetings that were never placed leave no empty calendars behind. Person
+// indexes from `first` on held elsewhere are invalidated. False when out of
+// memory, with nobody dropped.
+bool drop_idle_people(MeetingScheduler *scheduler, int first) {
+    int count = scheduler->person_grids.count;
+    if (first >= count) return true;
+    bool *keep = calloc((size_t)(count - first), sizeof(bool));
+    int *renumber = malloc((size_t)(count - first) * sizeof(int));
+    if (!keep || !renumber) {
+        free(keep);
+        free(renumber);
+        return false;
+    }
+    size_t cells = (size_t)scheduler->week_count * MAX_DAYS;
+    for (int person = first; person < count; person++) {
+        const SlotMask *grid = person_grid(scheduler, person);
+        for (size_t cell = 0; cell < cells && !keep[person - first]; cell++) keep[person - first] = grid[cell] != 0;
+    }
+    // Removed series keep their attendee runs, so every pool entry counts
+    for (int i = 0; i < scheduler->attendee_pool.count; i++) {
+        int person = *(int *)store_at(&scheduler->attendee_pool, i);
+        if (person >= first) keep[person - first] = true;
+    }
+    int next = first;
+    for (int person = first; person < count; person++) {
+        renumber[person - first] = next;
+        if (!keep[person - first]) continue;
+        *(SlotMask **)store_at(&scheduler->person_grids, next++) = person_grid(scheduler, person);
+    }
+    if (next < count) {
+        for (int i = 0; i < scheduler->attendee_pool.count; i++) {
+            int *person = store_at(&scheduler->attendee_pool, i);
+            if (*person >= first) *person = renumber[*person - first];
+        }
+        store_truncate(&scheduler->person_grids, next);
+        intern_drop(&scheduler->people, first, keep);
+    }
+    free(keep);
+    free(renumber);
+    return true;
+}
+
+// Union of the organiser's occupancy and every attendee's, laid out like
+// occupancy. Each attendee is one OR over contiguous week-major masks, a loop
+// the compiler turns into full-width vector ORs, so a 40-person meeting over
+// a quarter costs about as much as copying 40 small arrays.
+const SlotMask *meeting_busy(MeetingScheduler *scheduler, const Meeting *meeting) {
+    if (meeting->attendee_count == 0) return scheduler->occupancy;
+    size_t cells = (size_t)scheduler->week_count * MAX_DAYS;
+    SlotMask *restrict busy = scheduler->busy;
+    memcpy(busy, scheduler->occupancy, cells * sizeof(SlotMask));
+    for (int a = 0; a < meeting->attendee_count; a++) {
+        const SlotMask *restrict grid = person_grid(scheduler, meeting->attendees[a]);
+        for (size_t i = 0; i < cells; i++) busy[i] |= grid[i];
+    }
+    return busy;
+}
+
+// The same union for a single cell, week * MAX_DAYS + day, without the scratch copy
+static SlotMask cell_busy(const MeetingScheduler *scheduler, const Meeting *meeting, size_t cell) {
+    SlotMask busy = scheduler->occupancy[cell];
+    for (int a = 0; a < meeting->attendee_count; a++) busy |= person_grid(scheduler, meeting->attendees[a])[cell];
+    return busy;
+}
+
+// Reserve slots
+bool reserve_slot(MeetingScheduler *scheduler, const char *day, const char *start_time, int duration_minutes) {
+    int day_idx = find_day_index(day);
+    int start_idx = find_slot_index(start_time);
+    int duration_slots = minutes_to_slots(duration_minutes);
+    if (day_idx == -1 || day_idx >= scheduler->day_count || start_idx == -1 || duration_slots == 0) {
+        printf("Error: Invalid reservation: %s %s %d min\n", day, start_time, duration_minutes);
+        return false;
+    }
+    return reserve_slot_index(scheduler, day_idx, start_idx, duration_slots);
+}
+
+// Reserve by DAYS/TIME_SLOTS index, in every week of the horizon
+bool reserve_slot_index(MeetingScheduler *scheduler, int day_idx, int start_idx, int duration_slots) {
+    // Validate slot
+    if (day_idx < 0 || day_idx >= scheduler->day_count || start_idx < 0 ||
+        !(allowed_starts(duration_slots) >> start_idx & 1)) {
+        return false;
+    }
+
+    // Add reservation
+    SlotMask run = run_mask(start_idx, duration_slots);
+    for (int week = 0; week < scheduler->week_count; week++) {
+        SlotMask clash = *occupancy_cell(scheduler, week, day_idx) & run;
+        if (clash) {
+            printf("Error: Slot %s %s already reserved\n", DAYS[day_idx], TIME_SLOTS[__builtin_ctzll(clash)]);
+            return false;
+        }
+    }
+    int res_idx = scheduler->reservations.count;
+    Reservation *res = store_push(&scheduler->reservations);
+    if (!res || !store_push(&scheduler->reservation_next)) {
+        store_truncate(&scheduler->reservations, res_idx);
+        printf("Error: Out of memory\n");
+        return false;
+    }
+    for (int week = 0; week < scheduler->week_count; week++) {
+        *occupancy_cell(scheduler, week, day_idx) |= run;
+    }
+    res->day = day_idx;
+    res->start_time = start_idx;
+    res->duration = duration_slots;
+    index_reservation(scheduler, res_idx);
+    scheduler->total_hours[day_idx] += duration_hours(duration_slots) * scheduler->week_count;
+    day_load_changed(scheduler, day_idx);
+    return true;
+}
+
+// Blocks one whole (week, day) cell, e.g. a day outside the planned month
+bool block_day(MeetingScheduler *scheduler, int week, int day_idx) {
+    if (week < 0 || week >= scheduler->week_count || day_idx < 0 || day_idx >= scheduler->day_count) return false;
+    *occupancy_cell(scheduler, week, day_idx) |= allowed_starts(1);
+    return true;
+}
+
+// Calendar dates
+bool parse_date(const char *text, int *year, int *month, int *day) {
+    for (int i = 0; i < 10; i++) {
+        if (i == 4 || i == 7 ? text[i] != '-' : text[i] < '0' || text[i] > '9') return false;
+    }
+    *year = atoi(text);
+    *month = atoi(text + 5);
+    *day = atoi(text + 8);
+    if (*month < 1 || *month > 12 || *day < 1) return false;
+    // Reject days past the end of the month by round-tripping
+    int y, m, d;
+    civil_from_days(days_from_civil(*year, *month, *day), &y, &m, &d);
+    return d == *day;
+}
+
+// Starts week 0 on the Monday on or before the given date. Holidays are
+// stored by week, so any already added are dropped.
+bool set_calendar_start(MeetingScheduler *scheduler, int year, int month, int day) {
+    if (month < 1 || month > 12 || day < 1 || day > 31) return false;
+    long date = days_from_civil(year, month, day);
+    scheduler->start_date = date - weekday_from_days(date);
+    memset(scheduler->holidays, 0, scheduler->week_count);
+    scheduler->holiday_count = 0;
+    return true;
+}
+
+long calendar_date(const MeetingScheduler *scheduler, int week, int day_idx) {
+    return scheduler->start_date + (long)week * 7 + day_idx;
+}
+
+// Marks a date as a holiday; false when it lies outside the horizon
+bool add_holiday(MeetingScheduler *scheduler, int year, int month, int day) {
+    long offset = days_from_civil(year, month, day) - scheduler->start_date;
+    if (offset < 0 || offset >= (long)scheduler->week_count * 7) return false;
+    uint8_t bit = (uint8_t)(1u << (offset % 7));
+    if (!(scheduler->holidays[offset / 7] & bit)) scheduler->holiday_count++;
+    scheduler->holidays[offset / 7] |= bit;
+    return true;
+}
+
+// Reads "YYYY-MM-DD [name]" lines; blank lines and lines starting with '#'
+// are skipped. Returns the number of holidays inside the horizon, or -1.
+int load_holidays(MeetingScheduler *scheduler, const char *path) {
+    FILE *fp = fopen(path, "r");
+    if (!fp) {
+        printf("Error: Cannot open %s\n", path);
+        return -1;
+    }
+    char line[256];
+    int line_no = 0, count = 0;
+    while (fgets(line, sizeof(line), fp)) {
+        line_no++;
+        if (!strchr(line, '\n')) {
+            int c;
+            while ((c = getc(fp)) != EOF && c != '\n') {} // Only the date matters
+        }
+        char *text = line + strspn(line, " \t");
+        if (*text == '#' || *text == '\n' || *text == '\r' || *text == '\0') continue;
+        int year, month, day;
+        if (!parse_date(text, &year, &month, &day) || (text[10] && !strchr(" \t\r\n", text[10]))) {
+            printf("Error: %s:%d: expected a YYYY-MM-DD date\n", path, line_no);
+            fclose(fp);
+            return -1;
+        }
+        if (add_holiday(scheduler, year, month, day)) count++;
+    }
+    fclose(fp);
+    return count;
+}
+
+// Check slot validity
+bool is_valid_slot(MeetingScheduler *scheduler, int week, int day_idx, int start_idx, int duration_slots) {
+    return start_idx >= 0 && start_idx < MAX_SLOTS && (allowed_starts(duration_slots) >> start_idx & 1) &&
+           !(*occupancy_cell(scheduler, week, day_idx) & run_mask(start_idx, duration_slots));
+}
+
+// Starts of one day that fit some rule phase + k * period, phase < phases,
+// k < occurrences:
+// free in each of its weeks, where a holiday counts as free for every start
+// since that occurrence is skipped or shifted rather than placed there. The
+// per-week masks are left in week_starts for choosing the phase.
+static SlotMask starts_free_in_rule(const MeetingScheduler *scheduler, const SlotMask *busy, int day_idx,
+                                    int duration_slots, SlotMask candidates, int period, int occurrences,
+                                    int phases) {
+    SlotMask *week_free = scheduler->week_starts;
+    SlotMask holiday = allowed_starts(duration_slots) & candidates;
+    for (int week = 0; week < scheduler->week_count; week++) {
+        week_free[week] = is_holiday(scheduler, week, day_idx) ? holiday :
+                     starts_clear_of(busy[(size_t)week * MAX_DAYS + day_idx], duration_slots) & candidates;
+    }
+    SlotMask usable = 0;
+    for (int phase = 0; phase < phases && usable != holiday; phase++) {
+        SlotMask starts = holiday;
+        for (int k = 0; k < occurrences && starts; k++) starts &= week_free[phase + k * period];
+        usable |= starts;
+    }
+    STATS_ADD(rule_checks, 1);
+    if (!usable) STATS_ADD(rule_checks_empty, 1);
+    return usable;
+}
+
+// Checks what placement relies on; errors are printed only when `report` is set
+static bool check_meeting(const MeetingScheduler *scheduler, const Meeting *meeting, bool report) {
+    if ((unsigned)meeting->frequency >= FREQ_COUNT) {
+        if (report) printf("Error: Invalid frequency for %s\n", meeting->name);
+        return false;
+    }
+    for (int a = 0; a < meeting->attendee_count; a++) {
+        if (meeting->attendees[a] < 0 || meeting->attendees[a] >= scheduler->person_grids.count) {
+            if (report) printf("Error: Unknown attendee for %s\n", meeting->name);
+            return false;
+        }
+    }
+    return true;
+}
+
+// The meeting's fixed day, or -1 when any working day will do
+static int meeting_fixed_day(const MeetingScheduler *scheduler, const Meeting *meeting) {
+    int day_idx = meeting->fixed_day[0] ? find_day_index(meeting->fixed_day) : -1;
+    return day_idx < scheduler->day_count ? day_idx : -1;
+}
+
+// Starts the meeting may take: its fixed time, else its preferred hours,
+// else any. preferred_count receives how many preferred hours it lists.
+static SlotMask meeting_candidates(const Meeting *meeting, int *preferred_count) {
+    int fixed_time_idx = meeting->fixed_time[0] ? find_slot_index(meeting->fixed_time) : -1;
+    SlotMask candidates = ~(SlotMask)0;
+    *preferred_count = 0;
+    if (fixed_time_idx >= 0) {
+        candidates = (SlotMask)1 << fixed_time_idx;
+    } else if (meeting->preferred_hours[0] >= 0) {
+        candidates = 0;
+        while (*preferred_count < 8 && meeting->preferred_hours[*preferred_count] >= 0) {
+            int slot = meeting->preferred_hours[(*preferred_count)++];
+            if (slot < MAX_SLOTS) candidates |= (SlotMask)1 << slot;
+        }
+    }
+    return candidates;
+}
+
+// Add meeting; errors are printed only when `report` is set
+static bool schedule_meeting(MeetingScheduler *scheduler, const Meeting *meeting, bool report) {
+    if (!check_meeting(scheduler, meeting, report)) return false;
+    const SlotMask *busy = meeting_busy(scheduler, meeting);
+    int duration_slots = meeting->duration;
+    int period = frequency_period(meeting->frequency);
+    int occurrences = frequency_occurrences(meeting->frequency, scheduler->week_count);
+    int phases = frequency_phases(meeting->frequency, scheduler->week_count);
+    int fixed_day_idx = meeting_fixed_day(scheduler, meeting);
+    int chosen_day = -1, chosen_time = -1;
+
+    // Days by total hours, from the maintained load order; equally loaded days
+    // are tried in seeded random order, by their place in a shuffle
+    int days = scheduler->day_count;
+    int shuffled[MAX_DAYS], rank[MAX_DAYS], day_order[MAX_DAYS];
+    for (int i = 0; i < days; i++) shuffled[i] = i;
+    for (int i = days - 1; i > 0; i--) {
+        int j = scheduler_random(scheduler, i + 1);
+        int temp = shuffled[i];
+        shuffled[i] = shuffled[j];
+        shuffled[j] = temp;
+    }
+    for (int i = 0; i < days; i++) rank[shuffled[i]] = i;
+    for (int i = 0; i < days; i++) {
+        // Already sorted by load, so this only reorders runs of ties
+        int day = scheduler->load_order[i], j = i;
+        while (j > 0 && scheduler->total_hours[day_order[j - 1]] == scheduler->total_hours[day] &&
+               rank[day_order[j - 1]] > rank[day]) {
+            day_order[j] = day_order[j - 1];
+            j--;
+        }
+        day_order[j] = day;
+    }
+
+    int preferred_count;
+    SlotMask candidates = meeting_candidates(meeting, &preferred_count);
+
+    // Find consistent day and time: the least loaded day with a start that fits a rule
+    int week_count = scheduler->week_count;
+    int day_count = fixed_day_idx >= 0 ? 1 : days;
+    for (int d = 0; d < day_count && chosen_day == -1; d++) {
+        int day_idx = fixed_day_idx >= 0 ? fixed_day_idx : day_order[d];
+        if (scheduler->meeting_hours[day_idx] / week_count > 2.5) { // Cap at 2.5 hours/week
+            STATS_ADD(rejections[REJECT_DAILY_CAP], 1);
+            continue;
+        }
+        SlotMask usable = starts_free_in_rule(scheduler, busy, day_idx, duration_slots, candidates, period, occurrences,
+                                              phases);
+        STATS_CANDIDATES(candidates, usable, duration_slots);
+        if (!usable) continue;
+        chosen_day = day_idx;
+        if (preferred_count > 0) {
+            // Honour the caller's preference order rather than slot order
+            for (int t = 0; t < preferred_count; t++) {
+                int slot = meeting->preferred_hours[t];
+                if (slot < MAX_SLOTS && (usable >> slot & 1)) {
+                    chosen_time = slot;
+                    break;
+                }
+            }
+        } else {
+            chosen_time = __builtin_ctzll(usable);
+        }
+    }
+
+    if (chosen_day == -1 || chosen_time == -1) {
+        if (report) printf("Error: No consistent slot for %s (%s)\n", meeting->name, FREQUENCIES[meeting->frequency]);
+        return false;
+    }
+
+    // Phase: seeded random among the rules the chosen start fits, preferring
+    // those that lose the fewest occurrences to holidays
+    const SlotMask *week_free = scheduler->week_starts;
+    int phase = -1, fewest = occurrences + 1, ties = 0;
+    for (int p = 0; p < phases; p++) {
+        int holidays = 0;
+        bool fits = true;
+        for (int k = 0; k < occurrences && fits; k++) {
+            int week = p + k * period;
+            fits = week_free[week] >> chosen_time & 1;
+            holidays += is_holiday(scheduler, week, chosen_day);
+        }
+        if (!fits || holidays > fewest) continue;
+        if (holidays < fewest) {
+            fewest = holidays;
+            ties = 0;
+        }
+        if (scheduler_random(scheduler, ++ties) == 0) phase = p; // Each tie equally likely
+    }
+    if (place_meeting(scheduler, meeting, chosen_day, chosen_time, phase, occurrences) < 0) {
+        if (report) printf("Error: Out of memory placing %s\n", meeting->name);
+        return false;
+    }
+    return true;
+}
+
+// Times and counts one placement when built with SCHEDULER_STATS
+static bool instrumented_schedule(MeetingScheduler *scheduler, const Meeting *meeting, bool report) {
+    PHASE_BEGIN(PHASE_PLACE);
+    bool placed = schedule_meeting(scheduler, meeting, report);
+    PHASE_END(PHASE_PLACE);
+    STATS_ADD(add_meeting_calls, 1);
+    if (placed) STATS_ADD(meetings_placed, 1);
+    return placed;
+}
+
+bool add_meeting(MeetingScheduler *scheduler, const Meeting *meeting) {
+    return instrumented_schedule(scheduler, meeting, true);
+}
+
+// Same placement as add_meeting without printing, for callers running many attempts
+bool try_add_meeting(MeetingScheduler *scheduler, const Meeting *meeting) {
+    return instrumented_schedule(scheduler, meeting, false);
+}
+
+// Batch placement
+// Starts a meeting could take on an empty calendar, over its allowed days,
+// per slot it lasts; lower is more constrained
+static double meeting_flexibility(const MeetingScheduler *scheduler, const Meeting *meeting) {
+    if (meeting->duration < 1) return 0;
+    int days = meeting_fixed_day(scheduler, meeting) >= 0 ? 1 : scheduler->day_count;
+    int preferred_count;
+    SlotMask starts = allowed_starts(meeting->duration) & meeting_candidates(meeting, &preferred_count);
+    return (double)days * __builtin_popcountll(starts) / meeting->duration;
+}
+
+typedef struct {
+    double flexibility;
+    int footprint; // Slots over the horizon
+    int index;
+} MeetingRank;
+
+static int compare_rank(const void *a, const void *b) {
+    const MeetingRank *x = a, *y = b;
+    if (x->flexibility != y->flexibility) return x->flexibility < y->flexibility ? -1 : 1;
+    if (x->footprint != y->footprint) return x->footprint - y->footprint;
+    return x->index - y->index;
+}
+
+// Meeting indexes in placement order: least flexible first. Frequency only
+// breaks ties, smaller footprint first: ranking weekly meetings ahead of
+// rarer ones spends the daily cap early and places fewer meetings overall.
+bool order_meetings(const MeetingScheduler *scheduler, const Meeting *meetings, int count, int *order) {
+    MeetingRank *ranks = malloc((size_t)(count > 0 ? count : 1) * sizeof(MeetingRank));
+    if (!ranks) return false;
+    for (int i = 0; i < count; i++) {
+        const Meeting *meeting = &meetings[i];
+        int occurrences = (unsigned)meeting->frequency < FREQ_COUNT ?
+                          frequency_occurrences(meeting->frequency, scheduler->week_count) : 0;
+        ranks[i] = (MeetingRank){meeting_flexibility(scheduler, meeting), meeting->duration * occurrences, i};
+    }
+    qsort(ranks, count, sizeof(MeetingRank), compare_rank);
+    for (int i = 0; i < count; i++) order[i] = ranks[i].index;
+    free(ranks);
+    return true;
+}
+
+// Places a whole meeting set, most constrained first, so a flexible meeting
+// listed early cannot take the only slot a fixed or long one could use.
+// series[i] (may be NULL) receives meeting i's series index or -1. Returns
+// the number placed, or -1 when out of memory.
+static int schedule_batch(MeetingScheduler *scheduler, const Meeting *meetings, int count, int *series,
+                          bool report) {
+    int *order = malloc((size_t)(count > 0 ? count : 1) * sizeof(int));
+    if (!order || !order_meetings(scheduler, meetings, count, order)) {
+        free(order);
+        if (report) printf("Error: Out of memory\n");
+        return -1;
+    }
+    int placed = 0;
+    scheduler->arena.failed = false;
+    if (series) {
+        for (int i = 0; i < count; i++) series[i] = -1;
+    }
+    for (int i = 0; i < count && placed >= 0; i++) {
+        int m = order[i];
+        int series_idx = scheduler->series.count;
+        bool ok = instrumented_schedule(scheduler, &meetings[m], report);
+        if (series) series[m] = ok ? series_idx : -1;
+        placed += ok;
+        if (!ok && scheduler->arena.failed) placed = -1; // Meetings placed so far stay in series[]
+    }
+    free(order);
+    return placed;
+}
+
+int add_meetings(MeetingScheduler *scheduler, const Meeting *meetings, int count, int *series) {
+    return schedule_batch(scheduler, meetings, count, series, true);
+}
+
+int try_add_meetings(MeetingScheduler *scheduler, const Meeting *meetings, int count, int *series) {
+    return schedule_batch(scheduler, meetings, count, series, false);
+}
+
+// Free-slot query
+// Orders candidates best first: the day left least loaded, which keeps the
+// day loads most even, then the emptier weeks, then the caller's preference
+// order, then day and start
+static bool better_slot(const FreeSlot *a, const FreeSlot *b, const int *preference) {
+    if (a->day_hours != b->day_hours) return a->day_hours < b->day_hours;
+    if (a->busy_slots != b->busy_slots) return a->busy_slots < b->busy_slots;
+    if (preference[a->start_time] != preference[b->start_time]) {
+        return preference[a->start_time] < preference[b->start_time];
+    }
+    if (a->day != b->day) return a->day < b->day;
+    return a->start_time < b->start_time;
+}
+
+// Inserts a candidate into out[0 .. *found), best first, keeping at most max
+static void keep_best(FreeSlot *out, int *found, int max, const FreeSlot *slot, const int *preference) {
+    int i = *found;
+    if (i == max) {
+        if (max == 0 || !better_slot(slot, &out[max - 1], preference)) return;
+        i--;
+    } else {
+        (*found)++;
+    }
+    for (; i > 0 && better_slot(slot, &out[i - 1], preference); i--) out[i] = out[i - 1];
+    out[i] = *slot;
+}
+
+// The best `max` placements add_meeting could make for this meeting, under
+// the same rules: its fixed day and time or preferred hours, the daily cap,
+// every occurrence free for the organiser and attendees, holidays per the
+// policy. Nothing is written, not even scratch, so readers may share a
+// scheduler. Each day walks every rule phase once, reading the occupancy
+// masks in place, which is about one mask per week of the horizon.
+// Returns how many were found, or -1 for an invalid meeting.
+int find_free_slots(const MeetingScheduler *scheduler, const Meeting *meeting, FreeSlot *out, int max) {
+    if (max < 0 || !check_meeting(scheduler, meeting, false)) return -1;
+    int duration_slots = meeting->duration;
+    int period = frequency_period(meeting->frequency);
+    int occurrences = frequency_occurrences(meeting->frequency, scheduler->week_count);
+    int phases = frequency_phases(meeting->frequency, scheduler->week_count);
+    int fixed_day_idx = meeting_fixed_day(scheduler, meeting);
+    int preferred_count;
+    SlotMask candidates = meeting_candidates(meeting, &preferred_count) & allowed_starts(duration_slots);
+    int preference[MAX_SLOTS];
+    for (int slot = 0; slot < MAX_SLOTS; slot++) preference[slot] = preferred_count;
+    for (int t = preferred_count - 1; t >= 0; t--) {
+        if (meeting->preferred_hours[t] < MAX_SLOTS) preference[meeting->preferred_hours[t]] = t;
+    }
+
+    int found = 0;
+    int first_day = fixed_day_idx >= 0 ? fixed_day_idx : 0;
+    int last_day = fixed_day_idx >= 0 ? fixed_day_idx : scheduler->day_count - 1;
+    for (int day_idx = first_day; day_idx <= last_day; day_idx++) {
+        if (scheduler->meeting_hours[day_idx] / scheduler->week_count > 2.5) continue; // As add_meeting's cap
+        // Best phase per start: fewest occurrences lost to holidays, as
+        // add_meeting prefers, then the fewest slots already taken
+        int best_phase[MAX_SLOTS], best_holidays[MAX_SLOTS], best_busy[MAX_SLOTS];
+        SlotMask usable = 0;
+        for (int phase = 0; phase < phases; phase++) {
+            SlotMask starts = candidates;
+            int holidays = 0, busy_slots = 0;
+            for (int k = 0; k < occurrences && starts; k++) {
+                int week = phase + k * period;
+                if (is_holiday(scheduler, week, day_idx)) {
+                    holidays++;
+                    continue;
+                }
+                SlotMask busy = cell_busy(scheduler, meeting, (size_t)week * MAX_DAYS + day_idx);
+                starts &= starts_clear_of(busy, duration_slots);
+                busy_slots += __builtin_popcountll(busy);
+            }
+            for (SlotMask bits = starts; bits; bits &= bits - 1) {
+                int slot = __builtin_ctzll(bits);
+                if ((usable >> slot & 1) && (holidays > best_holidays[slot] ||
+                    (holidays == best_holidays[slot] && busy_slots >= best_busy[slot]))) {
+                    continue;
+                }
+                best_phase[slot] = phase;
+                best_holidays[slot] = holidays;
+                best_busy[slot] = busy_slots;
+                usable |= (SlotMask)1 << slot;
+            }
+        }
+        for (SlotMask bits = usable; bits; bits &= bits - 1) {
+            int slot = __builtin_ctzll(bits);
+            // Occurrences a holiday skips or shifts away add no hours to this day
+            int placed = occurrences - best_holidays[slot];
+            FreeSlot candidate = {
+                .day = day_idx,
+                .start_time = slot,
+                .phase = best_phase[slot],
+                .occurrences = placed,
+                .day_hours = scheduler->total_hours[day_idx] + placed * duration_hours(duration_slots),
+                .busy_slots = best_busy[slot],
+            };
+            keep_best(out, &found, max, &candidate, preference);
+        }
+    }
+    return found;
+}
+
+// Day a holiday occurrence moves to: the next working day of the same week
+// that is no holiday and has the run free for the organiser and every
+// attendee, or -1 to skip it
+static int shifted_day(const MeetingScheduler *scheduler, const Meeting *meeting, int week, int day_idx,
+                       SlotMask run) {
+    if (scheduler->holiday_policy != HOLIDAY_SHIFT) return -1;
+    for (int d = day_idx + 1; d < scheduler->day_count; d++) {
+        if (!is_holiday(scheduler, week, d) && !(cell_busy(scheduler, meeting, (size_t)week * MAX_DAYS + d) & run)) {
+            return d;
+        }
+    }
+    return -1;
+}
+
+// Adds or takes every occurrence of a series on or off the calendar:
+// organiser and attendee occupancy, and the hour counters of its days
+static void occupy_series(MeetingScheduler *scheduler, int series_idx, bool on) {
+    const MeetingSeries *series = series_at(scheduler, series_idx);
+    SlotMask run = run_mask(series->start_time, series->duration);
+    double hours = on ? duration_hours(series->duration) : -duration_hours(series->duration);
+    unsigned days = 0;
+    OccurrenceIter it;
+    Occurrence occ;
+    series_occurrences(scheduler, series_idx, 0, scheduler->week_count, &it);
+    while (next_occurrence(&it, &occ)) {
+        size_t cell = (size_t)occ.week * MAX_DAYS + occ.day;
+        scheduler->occupancy[cell] = on ? scheduler->occupancy[cell] | run : scheduler->occupancy[cell] & ~run;
+        for (int a = 0; a < series->attendee_count; a++) {
+            SlotMask *grid = person_grid(scheduler, series_attendee(scheduler, series, a));
+            grid[cell] = on ? grid[cell] | run : grid[cell] & ~run;
+        }
+        scheduler->total_hours[occ.day] += hours;
+        scheduler->meeting_hours[occ.day] += hours;
+        days |= 1u << occ.day;
+    }
+    for (int d = 0; d < scheduler->day_count; d++) {
+        if (days >> d & 1) day_load_changed(scheduler, d);
+    }
+}
+
+// Records a meeting at a day and start, recurring `count` times from week
+// `phase`, and returns its series index. The caller has already checked that
+// every slot is free; weeks where the day is a holiday follow the
+// scheduler's HolidayPolicy. Returns -1, with nothing recorded, when out of
+// memory.
+int place_meeting(MeetingScheduler *scheduler, const Meeting *meeting, int day_idx, int start_idx,
+                  int phase, int count) {
+    int series_idx = scheduler->series.count;
+    int attendee_mark = scheduler->attendee_pool.count;
+    int exception_mark = scheduler->exceptions.count;
+    MeetingSeries *series = store_push(&scheduler->series);
+    if (!series) return -1;
+    series->name = intern_string(&scheduler->strings, meeting->name);
+    series->type = intern_string(&scheduler->strings, meeting->type);
+    bool ok = series->name != INTERN_NONE && series->type != INTERN_NONE;
+    series->phase = (uint16_t)phase;
+    series->occurrences = (uint16_t)count;
+    series->period = (uint8_t)frequency_period(meeting->frequency);
+    series->day = (uint8_t)day_idx;
+    series->start_time = (uint8_t)start_idx;
+    series->duration = (uint8_t)meeting->duration;
+    series->frequency = (uint8_t)meeting->frequency;
+    series->exception_count = 0;
+    series->first_exception = (uint32_t)scheduler->exceptions.count;
+    series->attendee_count = (uint16_t)meeting->attendee_count;
+    series->attendees = (uint32_t)scheduler->attendee_pool.count;
+    // Kept so remove_meeting and move_meeting can update the attendees' grids
+    for (int a = 0; a < meeting->attendee_count && ok; a++) {
+        int *attendee = store_push(&scheduler->attendee_pool);
+        if (attendee) *attendee = meeting->attendees[a];
+        ok = attendee != NULL;
+    }
+    if (scheduler->holiday_count) {
+        SlotMask run = run_mask(start_idx, meeting->duration);
+        for (int k = 0; k < count && ok; k++) {
+            int week = phase + k * series->period;
+            if (!is_holiday(scheduler, week, day_idx)) continue;
+            int day = shifted_day(scheduler, meeting, week, day_idx, run);
+            SeriesException *exception = store_push(&scheduler->exceptions);
+            ok = exception != NULL;
+            if (!ok) break;
+            exception->week = (uint16_t)week;
+            exception->day = (uint8_t)(day >= 0 ? day : OCCURRENCE_DROPPED);
+            series->exception_count++;
+        }
+    }
+    if (!ok) {
+        store_truncate(&scheduler->series, series_idx);
+        store_truncate(&scheduler->attendee_pool, attendee_mark);
+        store_truncate(&scheduler->exceptions, exception_mark);
+        return -1;
+    }
+    occupy_series(scheduler, series_idx, true);
+    return series_idx;
+}
+
+// Occurrences
+// Day the series takes place on in a week, or -1
+int occurrence_day(const MeetingScheduler *scheduler, const MeetingSeries *series, int week) {
+    int offset = week - series->phase;
+    if (offset < 0 || offset % series->period || offset / series->period >= series->occurrences) return -1;
+    for (int i = 0; i < series->exception_count; i++) {
+        const SeriesException *exception = series_exception(scheduler, series, i);
+        if (exception->week == week) return exception->day == OCCURRENCE_DROPPED ? -1 : exception->day;
+    }
+    return series->day;
+}
+
+// Starts a walk over the occurrences of a series in weeks from_week .. to_week - 1.
+// The rule gives the first and last index in range directly.
+void series_occurrences(const MeetingScheduler *scheduler, int series_idx, int from_week, int to_week,
+                        OccurrenceIter *it) {
+    const MeetingSeries *series = series_at(scheduler, series_idx);
+    int period = series->period;
+    it->scheduler = scheduler;
+    it->series = series;
+    it->series_idx = series_idx;
+    it->k = from_week > series->phase ? (from_week - series->phase + period - 1) / period : 0;
+    it->end = to_week > series->phase ? (to_week - series->phase + period - 1) / period : 0;
+    if (it->end > series->occurrences) it->end = series->occurrences;
+    it->exception = 0;
+}
+
+bool next_occurrence(OccurrenceIter *it, Occurrence *out) {
+    const MeetingSeries *series = it->series;
+    while (it->k < it->end) {
+        int week = series->phase + it->k++ * series->period;
+        int day = series->day;
+        // Exceptions are sorted by week, so one pass over them serves the whole walk
+        while (it->exception < series->exception_count) {
+            const SeriesException *exception = series_exception(it->scheduler, series, it->exception);
+            if (exception->week > week) break;
+            it->exception++;
+            if (exception->week == week) day = exception->day;
+        }
+        if (day == OCCURRENCE_DROPPED) continue;
+        *out = (Occurrence){it->series_idx, week, day, series->start_time, series->duration};
+        return true;
+    }
+    return false;
+}
+
+// Starts a walk over every occurrence dated from_date .. to_date, both
+// inclusive, of the live series
+void occurrences_between(const MeetingScheduler *scheduler, long from_date, long to_date, RangeIter *it) {
+    long first = from_date - scheduler->start_date, last = to_date - scheduler->start_date;
+    it->scheduler = scheduler;
+    it->from_date = from_date;
+    it->to_date = to_date;
+    it->from_week = first > 0 ? (int)(first / 7 < scheduler->week_count ? first / 7 : scheduler->week_count) : 0;
+    it->to_week = last >= 0 ? (int)(last / 7 < scheduler->week_count ? last / 7 + 1 : scheduler->week_count) : 0;
+    it->next_series = 0;
+    it->series.k = it->series.end = 0;
+}
+
+bool next_in_range(RangeIter *it, Occurrence *out) {
+    const MeetingScheduler *scheduler = it->scheduler;
+    for (;;) {
+        while (next_occurrence(&it->series, out)) {
+            // Only the first and last week can hold dates outside the range
+            long date = calendar_date(scheduler, out->week, out->day);
+            if (date >= it->from_date && date <= it->to_date) return true;
+        }
+        while (it->next_series < scheduler->series.count && !series_at(scheduler, it->next_series)->occurrences) {
+            it->next_series++;
+        }
+        if (it->next_series >= scheduler->series.count || it->from_week >= it->to_week) return false;
+        series_occurrences(scheduler, it->next_series++, it->from_week, it->to_week, &it->series);
+    }
+}
+
+// First week in which two series take overlapping slots of the same day, or
+// -1. Without exceptions this is arithmetic on the two rules: the weeks they
+// share are phase_a + i * period_a = phase_b + j * period_b, which repeat
+// every lcm(period_a, period_b), so at most period_b steps along a's rule
+// find the first. Series with exceptions are walked side by side instead.
+int series_clash(const MeetingScheduler *scheduler, const MeetingSeries *a, const MeetingSeries *b) {
+    if (!a->occurrences || !b->occurrences) return -1;
+    bool overlap = a->start_time < b->start_time + b->duration && b->start_time < a->start_time + a->duration;
+    if (!overlap) return -1;
+    if (!a->exception_count && !b->exception_count) {
+        if (a->day != b->day) return -1;
+        int last_a = a->phase + (a->occurrences - 1) * a->period;
+        int last_b = b->phase + (b->occurrences - 1) * b->period;
+        int low = a->phase > b->phase ? a->phase : b->phase;
+        int high = last_a < last_b ? last_a : last_b;
+        int week = a->phase + (low - a->phase + a->period - 1) / a->period * a->period;
+        for (int i = 0; i < b->period && week <= high; i++, week += a->period) {
+            if ((week - b->phase) % b->period == 0) return week;
+        }
+        return -1;
+    }
+    OccurrenceIter ia = {scheduler, a, -1, 0, a->occurrences, 0};
+    OccurrenceIter ib = {scheduler, b, -1, 0, b->occurrences, 0};
+    Occurrence oa, ob;
+    bool more_a = next_occurrence(&ia, &oa), more_b = next_occurrence(&ib, &ob);
+    while (more_a && more_b) {
+        if (oa.week == ob.week && oa.day == ob.day) return oa.week;
+        if (oa.week <= ob.week) {
+            more_a = next_occurrence(&ia, &oa);
+        } else {
+            more_b = next_occurrence(&ib, &ob);
+        }
+    }
+    return -1;
+}
+
+static MeetingSeries *live_series(MeetingScheduler *scheduler, int series_idx) {
+    if (series_idx < 0 || series_idx >= scheduler->series.count) return NULL;
+    MeetingSeries *series = series_at(scheduler, series_idx);
+    return series->occurrences ? series : NULL;
+}
+
+// First live series with the given meeting name, or -1
+int find_meeting(const MeetingScheduler *scheduler, const char *name) {
+    for (int i = 0; i < scheduler->series.count; i++) {
+        const MeetingSeries *series = series_at(scheduler, i);
+        if (series->occurrences && strcmp(scheduler_string(scheduler, series->name), name) == 0) return i;
+    }
+    return -1;
+}
+
+// Takes every occurrence of a series off the calendar. The series keeps its
+// index with zero occurrences, so other series indexes stay valid.
+bool remove_meeting(MeetingScheduler *scheduler, int series_idx) {
+    MeetingSeries *series = live_series(scheduler, series_idx);
+    if (!series) {
+        printf("Error: No meeting with index %d\n", series_idx);
+        return false;
+    }
+    occupy_series(scheduler, series_idx, false);
+    series->occurrences = 0;
+    return true;
+}
+
+// Moves every occurrence of a series to another day and start, in the same
+// weeks, which must not make it fall on a holiday; occurrences a holiday
+// moved join the rest and dropped ones stay dropped. Only the old and new
+// (week, day) cells of the series are touched; if any new slot is taken the
+// series stays where it was.
+bool move_meeting(MeetingScheduler *scheduler, int series_idx, int day_idx, int start_idx) {
+    MeetingSeries *series = live_series(scheduler, series_idx);
+    if (!series) {
+        printf("Error: No meeting with index %d\n", series_idx);
+        return false;
+    }
+    if (day_idx < 0 || day_idx >= scheduler->day_count || start_idx < 0 ||
+        !(allowed_starts(series->duration) >> start_idx & 1)) {
+        printf("Error: Invalid slot for %s\n", scheduler_string(scheduler, series->name));
+        return false;
+    }
+    OccurrenceIter it;
+    Occurrence occ;
+    series_occurrences(scheduler, series_idx, 0, scheduler->week_count, &it);
+    while (next_occurrence(&it, &occ)) {
+        if (is_holiday(scheduler, occ.week, day_idx)) {
+            printf("Error: %s is a holiday in week %d\n", DAYS[day_idx], occ.week + 1);
+            return false;
+        }
+    }
+    occupy_series(scheduler, series_idx, false);
+
+    SlotMask run = run_mask(start_idx, series->duration);
+    int clash_week = -1;
+    series_occurrences(scheduler, series_idx, 0, scheduler->week_count, &it);
+    while (clash_week < 0 && next_occurrence(&it, &occ)) {
+        size_t cell = (size_t)occ.week * MAX_DAYS + day_idx;
+        SlotMask busy = scheduler->occupancy[cell];
+        for (int a = 0; a < series->attendee_count; a++) {
+            busy |= person_grid(scheduler, series_attendee(scheduler, series, a))[cell];
+        }
+        if (busy & run) clash_week = occ.week;
+    }
+    if (clash_week < 0) {
+        series->day = (uint8_t)day_idx;
+        series->start_time = (uint8_t)start_idx;
+        for (int i = 0; i < series->exception_count; i++) {
+            SeriesException *exception = series_exception(scheduler, series, i);
+            if (exception->day != OCCURRENCE_DROPPED) exception->day = (uint8_t)day_idx;
+        }
+    }
+    occupy_series(scheduler, series_idx, true);
+    if (clash_week >= 0) {
+        // Name the meeting in the way when it is one; the slot may also be reserved or imported
+        for (int i = 0; i < scheduler->series.count; i++) {
+            const MeetingSeries *other = series_at(scheduler, i);
+            if (i == series_idx || !other->occurrences || occurrence_day(scheduler, other, clash_week) != day_idx ||
+                !(run_mask(other->start_time, other->duration) & run)) {
+                continue;
+            }
+            printf("Error: %s %s is taken by %s in week %d\n", DAYS[day_idx], TIME_SLOTS[start_idx],
+                   scheduler_string(scheduler, other->name), clash_week + 1);
+            return false;
+        }
+        printf("Error: %s %s is taken in week %d\n", DAYS[day_idx], TIME_SLOTS[start_idx], clash_week + 1);
+        return false;
+    }
+    return true;
+}
+
+// Schedule output
+// One source of schedule rows: a live series, or a reservation
+typedef struct {
+    int series; // Series index, or -1 for a reservation
+    int start_time;
+    int duration;
+    const char *name;
+    const char *type;
+    Frequency frequency;
+} ScheduleItem;
+
+// The (week, day) being written
+typedef struct {
+    int week;
+    int day;
+    char date[10]; // YYYY-MM-DD, unterminated
+} ScheduleDay;
+
+// Hooks of one output format. Whatever an item shows that is the same in
+// every week is formatted once, by item(), into a fragment that row() then
+// copies for each occurrence with the week and day around it. Unused hooks
+// are NULL.
+typedef struct {
+    void (*begin)(OutBuf *out, const MeetingScheduler *scheduler);
+    void (*item)(OutBuf *out, const MeetingScheduler *scheduler, const ScheduleItem *item);
+    void (*day)(OutBuf *out, const ScheduleDay *day, bool holiday, bool empty);
+    void (*row)(OutBuf *out, long row, const ScheduleDay *day, const char *item, size_t length);
+    void (*end)(OutBuf *out, const MeetingScheduler *scheduler, const double *average_hours);
+} ScheduleRenderer;
+
+// Hours rounded to `decimals` places
+static void put_hours(OutBuf *out, double hours, int decimals) {
+    char text[32];
+    int length = snprintf(text, sizeof(text), "%.*f", decimals, hours);
+    if (length > 0 && length < (int)sizeof(text)) outbuf_write(out, text, (size_t)length);
+}
+
+// Text: the human-readable week by week listing
+static void text_begin(OutBuf *out, const MeetingScheduler *scheduler) {
+    outbuf_puts(out, "\nWeekly Meeting Schedule (");
+    outbuf_int(out, scheduler->week_count);
+    outbuf_puts(out, "-week cycle):\n");
+}
+
+static void text_item(OutBuf *out, const MeetingScheduler *scheduler, const ScheduleItem *item) {
+    (void)scheduler;
+    outbuf_puts(out, "    ");
+    outbuf_puts(out, TIME_SLOTS[item->start_time]);
+    outbuf_puts(out, "–");
+    outbuf_puts(out, slot_end_label(item->start_time, item->duration));
+    outbuf_puts(out, " - ");
+    outbuf_puts(out, item->name);
+    outbuf_puts(out, " (");
+    outbuf_puts(out, item->type);
+    outbuf_puts(out, ", ");
+    outbuf_int(out, slots_to_minutes(item->duration));
+    outbuf_puts(out, " min, ");
+    outbuf_puts(out, FREQUENCIES[item->frequency]);
+    outbuf_puts(out, ")\n");
+}
+
+static void text_day(OutBuf *out, const ScheduleDay *day, bool holiday, bool empty) {
+    if (day->day == 0) {
+        outbuf_puts(out, "\nWeek ");
+        outbuf_int(out, day->week + 1);
+        outbuf_puts(out, ":\n");
+    }
+    outbuf_puts(out, "  ");
+    outbuf_puts(out, DAYS[day->day]);
+    outbuf_puts(out, holiday ? " (holiday):\n" : ":\n");
+    if (empty) outbuf_puts(out, "    No meetings.\n");
+}
+
+static void text_row(OutBuf *out, long row, const ScheduleDay *day, const char *item, size_t length) {
+    (void)row;
+    (void)day;
+    outbuf_write(out, item, length);
+}
+
+static void text_end(OutBuf *out, const MeetingScheduler *scheduler, const double *average_hours) {
+    if (scheduler->day_count < 5) outbuf_puts(out, "\nFriday: No meetings.\n");
+    outbuf_puts(out, "\nAverage hours per day (meetings over ");
+    outbuf_int(out, scheduler->week_count);
+    outbuf_puts(out, " weeks):");
+    for (int d = 0; d < scheduler->day_count; d++) {
+        outbuf_char(out, ' ');
+        outbuf_puts(out, DAYS[d]);
+        outbuf_puts(out, ": ");
+        put_hours(out, average_hours[d], 1);
+    }
+    outbuf_puts(out, "\nTotal hours per day (meetings + reservations):");
+    for (int d = 0; d < scheduler->day_count; d++) {
+        outbuf_char(out, ' ');
+        outbuf_puts(out, DAYS[d]);
+        outbuf_puts(out, ": ");
+        put_hours(out, scheduler->total_hours[d] / scheduler->week_count, 1);
+    }
+    outbuf_char(out, '\n');
+}
+
+// JSON: one object with an occurrences array, one occurrence per line
+static void put_json_string(OutBuf *out, const char *text) {
+    outbuf_char(out, '"');
+    for (const unsigned char *c = (const unsigned char *)text; *c; c++) {
+        if (*c == '"' || *c == '\\') {
+            outbuf_char(out, '\\');
+            outbuf_char(out, (char)*c);
+        } else if (*c < 0x20) {
+            outbuf_puts(out, "\\u00");
+            outbuf_char(out, "0123456789abcdef"[*c >> 4]);
+            outbuf_char(out, "0123456789abcdef"[*c & 15]);
+        } else {
+            outbuf_char(out, (char)*c);
+        }
+    }
+    outbuf_char(out, '"');
+}
+
+// YYYY-MM-DD for a day number, without a terminator
+static void iso_date(char *out, long days) {
+    int year, month, day;
+    civil_from_days(days, &year, &month, &day);
+    out[0] = (char)('0' + year / 1000 % 10);
+    out[1] = (char)('0' + year / 100 % 10);
+    out[2] = (char)('0' + year / 10 % 10);
+    out[3] = (char)('0' + year % 10);
+    out[4] = '-';
+    out[5] = (char)('0' + month / 10);
+    out[6] = (char)('0' + month % 10);
+    out[7] = '-';
+    out[8] = (char)('0' + day / 10);
+    out[9] = (char)('0' + day % 10);
+}
+
+static void put_iso_date(OutBuf *out, long days) {
+    char date[10];
+    iso_date(date, days);
+    outbuf_write(out, date, sizeof(date));
+}
+
+static void json_begin(OutBuf *out, const MeetingScheduler *scheduler) {
+    outbuf_puts(out, "{\"weeks\": ");
+    outbuf_int(out, scheduler->week_count);
+    outbuf_puts(out, ", \"start_date\": \"");
+    put_iso_date(out, scheduler->start_date);
+    outbuf_puts(out, "\", \"occurrences\": [");
+}
+
+static void json_item(OutBuf *out, const MeetingScheduler *scheduler, const ScheduleItem *item) {
+    (void)scheduler;
+    outbuf_puts(out, ", \"start\": \"");
+    outbuf_puts(out, TIME_SLOTS[item->start_time]);
+    outbuf_puts(out, "\", \"end\": \"");
+    outbuf_puts(out, slot_end_label(item->start_time, item->duration));
+    outbuf_puts(out, "\", \"minutes\": ");
+    outbuf_int(out, slots_to_minutes(item->duration));
+    if (item->series >= 0) {
+        outbuf_puts(out, ", \"kind\": \"meeting\", \"series\": ");
+        outbuf_int(out, item->series);
+    } else {
+        outbuf_puts(out, ", \"kind\": \"reservation\", \"series\": null");
+    }
+    outbuf_puts(out, ", \"name\": ");
+    put_json_string(out, item->name);
+    outbuf_puts(out, ", \"type\": ");
+    put_json_string(out, item->type);
+    outbuf_puts(out, ", \"frequency\": \"");
+    outbuf_puts(out, FREQUENCIES[item->frequency]);
+    outbuf_puts(out, "\"}");
+}
+
+static void json_row(OutBuf *out, long row, const ScheduleDay *day, const char *item, size_t length) {
+    outbuf_puts(out, row ? ",\n  {\"week\": " : "\n  {\"week\": ");
+    outbuf_int(out, day->week + 1);
+    outbuf_puts(out, ", \"date\": \"");
+    outbuf_write(out, day->date, 10);
+    outbuf_puts(out, "\", \"day\": \"");
+    outbuf_puts(out, DAYS[day->day]);
+    outbuf_char(out, '"');
+    outbuf_write(out, item, length);
+}
+
+static void json_end(OutBuf *out, const MeetingScheduler *scheduler, const double *average_hours) {
+    (void)average_hours;
+    outbuf_puts(out, "\n], \"holidays\": [");
+    bool first = true;
+    for (int week = 0; week < scheduler->week_count; week++) {
+        for (int d = 0; d < scheduler->day_count; d++) {
+            if (!is_holiday(scheduler, week, d)) continue;
+            outbuf_puts(out, first ? "\"" : ", \"");
+            put_iso_date(out, calendar_date(scheduler, week, d));
+            outbuf_char(out, '"');
+            first = false;
+        }
+    }
+    outbuf_puts(out, "], \"days\": [");
+    for (int d = 0; d < scheduler->day_count; d++) {
+        outbuf_puts(out, d ? ",\n  {\"day\": \"" : "\n  {\"day\": \"");
+        outbuf_puts(out, DAYS[d]);
+        outbuf_puts(out, "\", \"meeting_hours_per_week\": ");
+        put_hours(out, scheduler->meeting_hours[d] / scheduler->week_count, 2);
+        outbuf_puts(out, ", \"total_hours_per_week\": ");
+        put_hours(out, scheduler->total_hours[d] / scheduler->week_count, 2);
+        outbuf_char(out, '}');
+    }
+    outbuf_puts(out, "\n]}\n");
+}
+
+// CSV: a header line, then one line per occurrence
+static void put_csv_field(OutBuf *out, const char *text) {
+    if (!text[strcspn(text, ",\"\r\n")]) {
+        outbuf_puts(out, text);
+        return;
+    }
+    outbuf_char(out, '"');
+    for (const char *c = text; *c; c++) {
+        if (*c == '"') outbuf_char(out, '"');
+        outbuf_char(out, *c);
+    }
+    outbuf_char(out, '"');
+}
+
+static void csv_begin(OutBuf *out, const MeetingScheduler *scheduler) {
+    (void)scheduler;
+    outbuf_puts(out, "week,date,day,start,end,minutes,kind,series,name,type,frequency\n");
+}
+
+static void csv_item(OutBuf *out, const MeetingScheduler *scheduler, const ScheduleItem *item) {
+    (void)scheduler;
+    outbuf_char(out, ',');
+    outbuf_puts(out, TIME_SLOTS[item->start_time]);
+    outbuf_char(out, ',');
+    outbuf_puts(out, slot_end_label(item->start_time, item->duration));
+    outbuf_char(out, ',');
+    outbuf_int(out, slots_to_minutes(item->duration));
+    if (item->series >= 0) {
+        outbuf_puts(out, ",meeting,");
+        outbuf_int(out, item->series);
+    } else {
+        outbuf_puts(out, ",reservation,");
+    }
+    outbuf_char(out, ',');
+    put_csv_field(out, item->name);
+    outbuf_char(out, ',');
+    put_csv_field(out, item->type);
+    outbuf_char(out, ',');
+    outbuf_puts(out, FREQUENCIES[item->frequency]);
+    outbuf_char(out, '\n');
+}
+
+static void csv_row(OutBuf *out, long row, const ScheduleDay *day, const char *item, size_t length) {
+    (void)row;
+    outbuf_int(out, day->week + 1);
+    outbuf_char(out, ',');
+    outbuf_write(out, day->date, 10);
+    outbuf_char(out, ',');
+    outbuf_puts(out, DAYS[day->day]);
+    outbuf_write(out, item, length);
+}
+
+static const ScheduleRenderer RENDERERS[SCHEDULE_FORMAT_COUNT] = {
+    [SCHEDULE_TEXT] = {text_begin, text_item, text_day, text_row, text_end},
+    [SCHEDULE_JSON] = {json_begin, json_item, NULL, json_row, json_end},
+    [SCHEDULE_CSV] = {csv_begin, csv_item, NULL, csv_row, NULL},
+};
+
+// ScheduleFormat for a SCHEDULE_FORMATS name, or -1
+int parse_schedule_format(const char *name) {
+    for (int f = 0; f < SCHEDULE_FORMAT_COUNT; f++) {
+        if (strcmp(name, SCHEDULE_FORMATS[f]) == 0) return f;
+    }
+    return -1;
+}
+
+// Appends the schedule to `out` week by week, each day's meetings and
+// reservations by start time. Returns false when out of memory.
+bool format_schedule(const MeetingScheduler *scheduler, ScheduleFormat format, OutBuf *out) {
+    if ((unsigned)format >= SCHEDULE_FORMAT_COUNT) return false;
+    const ScheduleRenderer *renderer = &RENDERERS[format];
+    int week_count = scheduler->week_count;
+    int series_count = scheduler->series.count;
+    int item_count = series_count + scheduler->reservations.count;
+    // Live series by start slot, then by index: a counting sort, since there are few slots
+    int *by_start = malloc(((size_t)series_count * (MAX_DAYS + 1) + 1) * sizeof(int));
+    size_t *fragment = malloc(((size_t)item_count + 1) * sizeof(size_t));
+    OutBuf fragments;
+    outbuf_init(&fragments, NULL, 4096);
+    if (!by_start || !fragment || fragments.failed) {
+        free(by_start);
+        free(fragment);
+        outbuf_free(&fragments);
+        return false;
+    }
+    int *day_lists = by_start + series_count; // Per day of the week being written
+    int first[MAX_SLOTS + 1] = {0};
+    for (int i = 0; i < series_count; i++) {
+        const MeetingSeries *series = series_at(scheduler, i);
+        if (series->occurrences) first[series->start_time + 1]++;
+    }
+    for (int t = 0; t < MAX_SLOTS; t++) first[t + 1] += first[t];
+    int live = first[MAX_SLOTS];
+    for (int i = 0; i < series_count; i++) {
+        const MeetingSeries *series = series_at(scheduler, i);
+        if (series->occurrences) by_start[first[series->start_time]++] = i;
+    }
+
+    // Every item's fragment, series first and then reservations
+    for (int i = 0; i < item_count; i++) {
+        fragment[i] = fragments.len;
+        ScheduleItem item = {-1, 0, 0, NULL, NULL, FREQ_WEEKLY};
+        if (i < series_count) {
+            const MeetingSeries *series = series_at(scheduler, i);
+            if (!series->occurrences) continue;
+            item = (ScheduleItem){i, series->start_time, series->duration, scheduler_string(scheduler, series->name),
+                                  scheduler_string(scheduler, series->type), (Frequency)series->frequency};
+        } else {
+            const Reservation *res = reservation_at(scheduler, i - series_count);
+            item = (ScheduleItem){-1, res->start_time, res->duration, scheduler_string(scheduler, scheduler->reserved_name),
+                                  scheduler_string(scheduler, scheduler->reserved_type), FREQ_WEEKLY};
+        }
+        renderer->item(&fragments, scheduler, &item);
+    }
+    fragment[item_count] = fragments.len;
+    // Reserve the whole output up front, so a large schedule is not copied as
+    // the buffer doubles; the week and day around each fragment are short
+    size_t estimate = 0;
+    for (int i = 0; i < item_count; i++) {
+        int rows = i < series_count ? series_at(scheduler, i)->occurrences : week_count;
+        estimate += (fragment[i + 1] - fragment[i] + 64) * (size_t)rows;
+    }
+    outbuf_reserve(out, estimate);
+
+    if (renderer->begin) renderer->begin(out, scheduler);
+    double average_hours[MAX_DAYS] = {0};
+    long row = 0;
+    for (int week = 0; week < week_count; week++) {
+        // One pass over the series sorts this week's occurrences into their days
+        int day_length[MAX_DAYS] = {0};
+        for (int i = 0; i < live; i++) {
+            int day = occurrence_day(scheduler, series_at(scheduler, by_start[i]), week);
+            if (day >= 0) day_lists[(size_t)day * series_count + day_length[day]++] = by_start[i];
+        }
+        for (int d = 0; d < scheduler->day_count; d++) {
+            ScheduleDay day = {.week = week, .day = d};
+            iso_date(day.date, calendar_date(scheduler, week, d));
+            int r = scheduler->reservation_head[d];
+            if (renderer->day) renderer->day(out, &day, is_holiday(scheduler, week, d), day_length[d] == 0 && r < 0);
+            // Meetings and reservations are both in start-slot order; merge the two
+            const int *list = day_lists + (size_t)d * series_count;
+            int e = 0;
+            while (e < day_length[d] || r >= 0) {
+                const MeetingSeries *series = e < day_length[d] ? series_at(scheduler, list[e]) : NULL;
+                const Reservation *res = r >= 0 ? reservation_at(scheduler, r) : NULL;
+                int item;
+                if (series && (!res || series->start_time < res->start_time)) {
+                    item = list[e++];
+                    int occ = frequency_occurrences(series->frequency, week_count);
+                    average_hours[d] += duration_hours(series->duration) * occ / week_count;
+                } else {
+                    item = series_count + r;
+                    r = reservation_next(scheduler, r);
+                }
+                renderer->row(out, row++, &day, fragments.data + fragment[item], fragment[item + 1] - fragment[item]);
+            }
+        }
+    }
+    if (renderer->end) renderer->end(out, scheduler, average_hours);
+    bool ok = !fragments.failed && !out->failed;
+    free(by_start);
+    free(fragment);
+    outbuf_free(&fragments);
+    return ok;
+}
+
+// Writes the schedule to fp in one write, without reporting; false when it
+// could not be formatted or written
+bool write_schedule(const MeetingScheduler *scheduler, ScheduleFormat format, FILE *fp) {
+    OutBuf out;
+    outbuf_init(&out, NULL, 0);
+    bool ok = format_schedule(scheduler, format, &out) &&
+              fwrite(out.data, 1, out.len, fp) == out.len;
+    outbuf_free(&out);
+    return ok;
+}
+
+// Display schedule
+void display_schedule(MeetingScheduler *scheduler) {
+    if (!write_schedule(scheduler, SCHEDULE_TEXT, stdout)) printf("Error: Out of memory\n");
+}
+
+// ICS export
+// YYYYMMDDTHHMMSS for a day number and minutes since midnight
+static void put_ics_datetime(OutBuf *out, long days, int minutes) {
+    int year, month, day;
+    civil_from_days(days, &year, &month, &day);
+    outbuf_digits(out, (unsigned)year, 4);
+    outbuf_digits(out, (unsigned)month, 2);
+    outbuf_digits(out, (unsigned)day, 2);
+    outbuf_char(out, 'T');
+    outbuf_digits(out, (unsigned)(minutes / 60), 2);
+    outbuf_digits(out, (unsigned)(minutes % 60), 2);
+    outbuf_puts(out, "00");
+}
+
+// EXDATE for each occurrence of the rule a holiday moved or dropped, and
+// RDATE for the day each moved one takes place on
+static void put_ics_exceptions(OutBuf *out, const MeetingScheduler *scheduler, const MeetingSeries *series) {
+    int minutes = slot_minutes(series->start_time);
+    for (int i = 0; i < series->exception_count; i++) {
+        const SeriesException *exception = series_exception(scheduler, series, i);
+        if (exception->day == series->day) continue;
+        outbuf_puts(out, "\nEXDATE:");
+        put_ics_datetime(out, calendar_date(scheduler, exception->week, series->day), minutes);
+    }
+    for (int i = 0; i < series->exception_count; i++) {
+        const SeriesException *exception = series_exception(scheduler, series, i);
+        if (exception->day == series->day || exception->day == OCCURRENCE_DROPPED) continue;
+        outbuf_puts(out, "\nRDATE:");
+        put_ics_datetime(out, calendar_date(scheduler, exception->week, exception->day), minutes);
+    }
+}
+
+// Writes the calendar to fp without reporting; false when a write failed
+bool write_ics(const MeetingScheduler *scheduler, FILE *fp) {
+    OutBuf out;
+    outbuf_init(&out, fp, 0);
+    outbuf_puts(&out, "BEGIN:VCALENDAR\n");
+    outbuf_puts(&out, "PRODID:-//Meeting Scheduler//xAI//EN\n");
+    outbuf_puts(&out, "VERSION:2.0\n");
+
+    // One event per series, written straight from its rule
+    for (int i = 0; i < scheduler->series.count; i++) {
+        const MeetingSeries *e = series_at(scheduler, i);
+        if (e->occurrences == 0) continue;
+        const char *name = scheduler_string(scheduler, e->name);
+        const char *type = scheduler_string(scheduler, e->type);
+        int minutes = slots_to_minutes(e->duration);
+        outbuf_puts(&out, "BEGIN:VEVENT\nSUMMARY:");
+        outbuf_puts(&out, name);
+        outbuf_puts(&out, " (");
+        outbuf_puts(&out, type);
+        outbuf_puts(&out, ")\nDTSTART:");
+        put_ics_datetime(&out, calendar_date(scheduler, e->phase, e->day), slot_minutes(e->start_time));
+        outbuf_puts(&out, "\nDURATION:PT");
+        outbuf_int(&out, minutes);
+        outbuf_puts(&out, "M\nRRULE:FREQ=WEEKLY;INTERVAL=");
+        outbuf_int(&out, e->period);
+        outbuf_puts(&out, ";COUNT=");
+        outbuf_int(&out, e->occurrences);
+        put_ics_exceptions(&out, scheduler, e);
+        outbuf_puts(&out, "\nDESCRIPTION:Type: ");
+        outbuf_puts(&out, type);
+        outbuf_puts(&out, ", Duration: ");
+        outbuf_int(&out, minutes);
+        outbuf_puts(&out, " min, Frequency: ");
+        outbuf_puts(&out, FREQUENCIES[e->frequency]);
+        outbuf_puts(&out, "\nEND:VEVENT\n");
+    }
+
+    // Reservations
+    for (int i = 0; i < scheduler->reservations.count; i++) {
+        const Reservation *r = reservation_at(scheduler, i);
+        int minutes = slots_to_minutes(r->duration);
+        outbuf_puts(&out, "BEGIN:VEVENT\nSUMMARY:Reserved (External)\nDTSTART:");
+        put_ics_datetime(&out, calendar_date(scheduler, 0, r->day), slot_minutes(r->start_time));
+        outbuf_puts(&out, "\nDURATION:PT");
+        outbuf_int(&out, minutes);
+        outbuf_puts(&out, "M\nRRULE:FREQ=WEEKLY\nDESCRIPTION:External commitment, Duration: ");
+        outbuf_int(&out, minutes);
+        outbuf_puts(&out, " min\nEND:VEVENT\n");
+    }
+
+    outbuf_puts(&out, "END:VCALENDAR\n");
+    bool ok = outbuf_flush(&out);
+    outbuf_free(&out);
+    return ok;
+}
+
+void export_to_ics(MeetingScheduler *scheduler, const char *filename) {
+    FILE *fp = fopen(filename, "w");
+    if (!fp) {
+        printf("Error: Cannot open %s\n", filename);
+        return;
+    }
+    bool ok = write_ics(scheduler, fp);
+    if (fclose(fp) != 0 || !ok) {
+        printf("Error: Failed writing %s\n", filename);
+        return;
+    }
+    printf("\nSchedule exported to %s\n", filename);
+}
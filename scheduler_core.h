@@ -0,0 +1,314 @@
+#ifndef SCHEDULER_CORE_H
+#define SCHEDULER_CORE_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "arena.h"
+#include "intern.h"
+#include "outbuf.h"
+
+#define MAX_DAYS 7 // Grid stride; a scheduler uses the first day_count days
+#define DEFAULT_DAYS 4 // Monday to Thursday
+#define DEFAULT_WEEKS 4 // Planning horizon used by init_scheduler
+#define MAX_SLOTS 64 // Slots per day a SlotMask can hold; the grid in use has slot_count()
+#define MAX_DURATION 16 // Longest meeting in slots the start tables can describe
+#define SCHEDULER_ARENA_BLOCK (256 * 1024)
+#define MAX_STR 64
+
+// Constants
+extern const char *DAYS[MAX_DAYS];
+extern const char *TIME_SLOTS[MAX_SLOTS]; // "HH:MM" start of each slot of the grid
+extern const char *FREQUENCIES[];
+extern const int DURATIONS[3]; // Standard meeting lengths in minutes
+
+// Layout of a working day, in minutes since midnight. It is process-wide:
+// configure it before creating any scheduler, since slot indexes, masks and
+// durations in slots all depend on it. The default is 30-minute slots from
+// 9:00 to 17:00 with a 12:00–13:00 break and meetings of up to 90 minutes.
+typedef struct {
+    int slot_minutes;
+    int day_start;
+    int day_end; // Meetings must end by this time
+    int break_start; // No slot overlaps the break; equal to break_end for none
+    int break_end;
+    int max_meeting_minutes;
+} GridConfig;
+
+typedef enum {
+    FREQ_WEEKLY,
+    FREQ_FORTNIGHTLY,
+    FREQ_THIRD_WEEK,
+    FREQ_MONTHLY,
+    FREQ_COUNT
+} Frequency; // Indexes FREQUENCIES
+
+// One bit per TIME_SLOTS index; a set bit in an occupancy mask means blocked
+typedef uint64_t SlotMask;
+
+// Structures
+typedef struct {
+    char name[MAX_STR];
+    char type[MAX_STR];
+    int duration; // Slots of the grid (1=30min, 2=60min, 3=90min by default)
+    int preferred_hours[8]; // Indices of TIME_SLOTS, -1 terminated
+    char fixed_day[MAX_STR];
+    char fixed_time[MAX_STR];
+    Frequency frequency;
+    const int *attendees; // Person indexes from add_person; the organiser is implicit
+    int attendee_count;
+} Meeting;
+
+typedef struct {
+    int day;
+    int start_time; // Index in TIME_SLOTS
+    int duration; // Slots
+} Reservation;
+
+// One add_meeting call, stored once as its rule: `occurrences` weeks from
+// week `phase`, every `period` weeks, on `day` at `start_time`. The only
+// occurrences kept individually are those a holiday moved or dropped.
+// Names and types are ids in the scheduler's intern table.
+typedef struct {
+    uint32_t name;
+    uint32_t type;
+    uint16_t phase; // First week of the rule
+    uint16_t occurrences; // Weeks the rule covers; 0 once removed
+    uint8_t period; // Weeks between occurrences, frequency_period(frequency)
+    uint8_t day;
+    uint8_t start_time; // Index in TIME_SLOTS
+    uint8_t duration; // Slots
+    uint8_t frequency; // Frequency
+    uint16_t exception_count;
+    uint32_t first_exception; // Exceptions are first_exception .. + exception_count, by week
+    uint16_t attendee_count;
+    uint32_t attendees; // First person index in MeetingScheduler.attendee_pool
+} MeetingSeries;
+
+#define OCCURRENCE_DROPPED 0xff
+
+// An occurrence of a series that a holiday moved to another day of its week
+// or dropped
+typedef struct {
+    uint16_t week;
+    uint8_t day; // Day it takes place on, or OCCURRENCE_DROPPED
+} SeriesException;
+
+#define MAX_HORIZON_WEEKS UINT16_MAX
+
+// What add_meeting does with an occurrence that falls on a holiday
+typedef enum {
+    HOLIDAY_SKIP, // Drop it
+    HOLIDAY_SHIFT // Move it to the next working day of that week with room, else drop it
+} HolidayPolicy;
+
+// Scheduler state; all storage lives in the arena and grows with the data
+typedef struct {
+    Arena arena;
+    int week_count; // Planning horizon in weeks
+    int day_count; // Working days per week, from Monday
+    Store series; // MeetingSeries
+    Store exceptions; // SeriesException, in runs per series
+    Store reservations; // Reservation
+    InternTable strings; // Meeting names and types
+    uint32_t reserved_name; // Interned labels used when listing reservations
+    uint32_t reserved_type;
+    double total_hours[MAX_DAYS]; // Meetings + reservations over the horizon
+    double meeting_hours[MAX_DAYS]; // Meetings only
+    uint8_t load_order[MAX_DAYS]; // Days by total_hours, least loaded first; kept up to date
+    SlotMask *occupancy; // week_count * MAX_DAYS masks, week-major
+    int reservation_head[MAX_DAYS]; // First reservation of each day; -1 if none
+    Store reservation_next; // int per reservation: next one on its day by start slot
+    SlotMask *week_starts; // Scratch for add_meeting, week_count masks
+    long start_date; // Day number (dates.h) of the Monday that starts week 0
+    uint8_t *holidays; // Per week, bit d set when day d is a holiday
+    int holiday_count;
+    HolidayPolicy holiday_policy;
+    uint64_t seed; // Last value given to seed_scheduler
+    uint64_t rng_state;
+    InternTable people; // Attendee names; ids are person indexes
+    Store person_grids; // SlotMask * per person, same layout as occupancy
+    Store attendee_pool; // int person indexes, referenced by MeetingSeries.attendees
+    SlotMask *busy; // Scratch for meeting_busy
+    void *mapping; // Snapshot file some of the state lives in, or NULL
+    size_t mapping_size;
+} MeetingScheduler;
+
+// One occurrence of a series, produced on demand from its rule
+typedef struct {
+    int series;
+    int week;
+    int day;
+    int start_time; // Index in TIME_SLOTS
+    int duration; // Slots
+} Occurrence;
+
+// Walks the occurrences of one series within a range of weeks, in week order
+typedef struct {
+    const MeetingScheduler *scheduler;
+    const MeetingSeries *series;
+    int series_idx;
+    int k; // Next rule index
+    int end; // One past the last rule index in range
+    int exception; // Next exception that may apply
+} OccurrenceIter;
+
+// Walks the occurrences of every live series dated within a range, series by series
+typedef struct {
+    const MeetingScheduler *scheduler;
+    long from_date; // Day numbers (dates.h), both inclusive
+    long to_date;
+    int from_week;
+    int to_week;
+    int next_series;
+    OccurrenceIter series;
+} RangeIter;
+
+// One placement find_free_slots reports; add_meeting could make it as is
+typedef struct {
+    int day;
+    int start_time; // Index in TIME_SLOTS
+    int phase; // First week of the rule
+    int occurrences; // Occurrences that would land on this day, after holidays
+    double day_hours; // total_hours of the day once placed; the ranking key
+    int busy_slots; // Slots already taken on this day in the weeks it would use
+} FreeSlot;
+
+// Bits covering duration_slots slots starting at start_idx
+static inline SlotMask run_mask(int start_idx, int duration_slots) {
+    return (((SlotMask)1 << duration_slots) - 1) << start_idx;
+}
+
+static inline SlotMask *occupancy_cell(const MeetingScheduler *scheduler, int week, int day_idx) {
+    return &scheduler->occupancy[(size_t)week * MAX_DAYS + day_idx];
+}
+
+static inline bool is_holiday(const MeetingScheduler *scheduler, int week, int day_idx) {
+    return scheduler->holidays[week] >> day_idx & 1;
+}
+
+static inline SlotMask *person_grid(const MeetingScheduler *scheduler, int person) {
+    return *(SlotMask **)store_at(&scheduler->person_grids, person);
+}
+
+static inline int series_attendee(const MeetingScheduler *scheduler, const MeetingSeries *series, int i) {
+    return *(int *)store_at(&scheduler->attendee_pool, (int)series->attendees + i);
+}
+
+static inline int reservation_next(const MeetingScheduler *scheduler, int i) {
+    return *(int *)store_at(&scheduler->reservation_next, i);
+}
+
+static inline const char *scheduler_string(const MeetingScheduler *scheduler, uint32_t id) {
+    return intern_lookup(&scheduler->strings, id);
+}
+
+static inline MeetingSeries *series_at(const MeetingScheduler *scheduler, int i) {
+    return store_at(&scheduler->series, i);
+}
+
+static inline SeriesException *series_exception(const MeetingScheduler *scheduler, const MeetingSeries *series, int i) {
+    return store_at(&scheduler->exceptions, (int)series->first_exception + i);
+}
+
+static inline Reservation *reservation_at(const MeetingScheduler *scheduler, int i) {
+    return store_at(&scheduler->reservations, i);
+}
+
+// Time grid
+const char *check_grid_config(const GridConfig *config); // NULL when usable, else the reason
+bool configure_grid(const GridConfig *config);
+bool parse_grid_config(const char *spec, GridConfig *config);
+const GridConfig *grid_config(void);
+int slot_count(void);
+int max_duration_slots(void);
+int minutes_to_slots(int minutes); // 0 unless a whole number of slots within the maximum
+int slots_to_minutes(int duration_slots);
+double duration_hours(int duration_slots);
+
+// Utility functions
+int find_slot_index(const char *time);
+int find_day_index(const char *day);
+bool is_break_slot(const char *time);
+double slot_to_hour(int slot_idx);
+int slot_minutes(int slot_idx);
+void compute_end_time(int start_idx, int duration_slots, char *end_time);
+const char *slot_end_label(int start_idx, int duration_slots);
+int parse_frequency(const char *frequency);
+int frequency_period(Frequency frequency);
+int frequency_occurrences(Frequency frequency, int week_count);
+int frequency_phases(Frequency frequency, int week_count);
+
+// Calendar dates. Weeks start on Mondays; holidays are kept per (week, day)
+// and dropped by reset_scheduler and set_calendar_start.
+bool parse_date(const char *text, int *year, int *month, int *day); // YYYY-MM-DD
+bool set_calendar_start(MeetingScheduler *scheduler, int year, int month, int day);
+bool add_holiday(MeetingScheduler *scheduler, int year, int month, int day);
+int load_holidays(MeetingScheduler *scheduler, const char *path);
+long calendar_date(const MeetingScheduler *scheduler, int week, int day_idx);
+
+// Occupancy masks
+SlotMask allowed_starts(int duration_slots);
+SlotMask slots_overlapping(int from_minutes, int to_minutes);
+SlotMask free_starts(const MeetingScheduler *scheduler, int week, int day_idx, int duration_slots);
+
+// Scheduling functions. Anything that stores data fails, and leaves the
+// scheduler as it was, when the arena runs out of memory; the arena's
+// `failed` flag tells that apart from a rejected request.
+bool init_scheduler(MeetingScheduler *scheduler);
+bool init_scheduler_horizon(MeetingScheduler *scheduler, int week_count);
+bool init_scheduler_days(MeetingScheduler *scheduler, int week_count, int day_count);
+bool reset_scheduler(MeetingScheduler *scheduler);
+void free_scheduler(MeetingScheduler *scheduler);
+void seed_scheduler(MeetingScheduler *scheduler, uint64_t seed);
+void sort_day_loads(MeetingScheduler *scheduler);
+uint32_t scheduler_random(MeetingScheduler *scheduler, uint32_t bound);
+bool reserve_slot(MeetingScheduler *scheduler, const char *day, const char *start_time, int duration_minutes);
+bool reserve_slot_index(MeetingScheduler *scheduler, int day_idx, int start_idx, int duration_slots);
+bool block_day(MeetingScheduler *scheduler, int week, int day_idx);
+int add_person(MeetingScheduler *scheduler, const char *name); // -1 when out of memory
+bool reserve_person_slot(MeetingScheduler *scheduler, int person, int day_idx, int start_idx, int duration_slots);
+bool drop_idle_people(MeetingScheduler *scheduler, int first);
+const SlotMask *meeting_busy(MeetingScheduler *scheduler, const Meeting *meeting);
+bool is_valid_slot(MeetingScheduler *scheduler, int week, int day_idx, int start_idx, int duration_slots);
+bool add_meeting(MeetingScheduler *scheduler, const Meeting *meeting);
+bool try_add_meeting(MeetingScheduler *scheduler, const Meeting *meeting);
+bool order_meetings(const MeetingScheduler *scheduler, const Meeting *meetings, int count, int *order);
+int add_meetings(MeetingScheduler *scheduler, const Meeting *meetings, int count, int *series);
+int try_add_meetings(MeetingScheduler *scheduler, const Meeting *meetings, int count, int *series);
+int find_free_slots(const MeetingScheduler *scheduler, const Meeting *meeting, FreeSlot *out, int max);
+int place_meeting(MeetingScheduler *scheduler, const Meeting *meeting, int day_idx, int start_idx,
+                  int phase, int count);
+int find_meeting(const MeetingScheduler *scheduler, const char *name);
+bool remove_meeting(MeetingScheduler *scheduler, int series_idx);
+bool move_meeting(MeetingScheduler *scheduler, int series_idx, int day_idx, int start_idx);
+
+// Occurrences, expanded lazily from the series rules
+int occurrence_day(const MeetingScheduler *scheduler, const MeetingSeries *series, int week);
+void series_occurrences(const MeetingScheduler *scheduler, int series_idx, int from_week, int to_week,
+                        OccurrenceIter *it);
+bool next_occurrence(OccurrenceIter *it, Occurrence *out);
+void occurrences_between(const MeetingScheduler *scheduler, long from_date, long to_date, RangeIter *it);
+bool next_in_range(RangeIter *it, Occurrence *out);
+int series_clash(const MeetingScheduler *scheduler, const MeetingSeries *a, const MeetingSeries *b);
+
+// Schedule output formats. Machine-readable ones have one row per occurrence
+// or weekly reservation: week (from 1), date, day, start and end "HH:MM",
+// minutes, kind ("meeting" or "reservation"), series index, name, type and
+// frequency. JSON also lists the holidays and per-day hours.
+typedef enum {
+    SCHEDULE_TEXT,
+    SCHEDULE_JSON,
+    SCHEDULE_CSV,
+    SCHEDULE_FORMAT_COUNT
+} ScheduleFormat; // Indexes SCHEDULE_FORMATS
+
+extern const char *SCHEDULE_FORMATS[SCHEDULE_FORMAT_COUNT];
+int parse_schedule_format(const char *name);
+bool format_schedule(const MeetingScheduler *scheduler, ScheduleFormat format, OutBuf *out);
+bool write_schedule(const MeetingScheduler *scheduler, ScheduleFormat format, FILE *fp);
+void display_schedule(MeetingScheduler *scheduler);
+bool write_ics(const MeetingScheduler *scheduler, FILE *fp);
+void export_to_ics(MeetingScheduler *scheduler, const char *filename);
+
+#endif
@@ -0,0 +1,343 @@
+"""
+Thin ctypes binding for libscheduler.so (see libscheduler.h).
+
+Build the library with `make libscheduler.so`; it is loaded from this
+directory, or from the path in the SCHEDULER_LIB environment variable.
+"""
+import ctypes
+import os
+
+API_VERSION = 9
+SCHED_ERR_MEMORY = -2  # Returned by calls that store data when memory ran out
+
+FREQUENCIES = {
+    "Weekly": 0,
+    "Fortnightly": 1,
+    "Every Third Week": 2,
+    "Monthly": 3,
+}
+
+SCHEDULE_FORMATS = {"text": 0, "json": 1, "csv": 2}
+
+DAYS = ["Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday", "Sunday"]
+
+
+class Occurrence(ctypes.Structure):
+    _fields_ = [
+        ("series", ctypes.c_int32),
+        ("week", ctypes.c_int32),
+        ("day", ctypes.c_int32),
+        ("start_minutes", ctypes.c_int32),
+        ("duration_minutes", ctypes.c_int32),
+    ]
+
+
+class MeetingRequest(ctypes.Structure):
+    _fields_ = [
+        ("name", ctypes.c_char_p),
+        ("type", ctypes.c_char_p),
+        ("duration_minutes", ctypes.c_int32),
+        ("frequency", ctypes.c_int32),
+        ("fixed_day", ctypes.c_int32),
+        ("fixed_slot", ctypes.c_int32),
+        ("preferred", ctypes.c_int32 * 8),
+        ("preferred_count", ctypes.c_int32),
+    ]
+
+
+class FreeSlot(ctypes.Structure):
+    _fields_ = [
+        ("day", ctypes.c_int32),
+        ("slot", ctypes.c_int32),
+        ("start_minutes", ctypes.c_int32),
+        ("first_week", ctypes.c_int32),
+        ("occurrences", ctypes.c_int32),
+        ("day_minutes", ctypes.c_int32),
+    ]
+
+
+class Cell(ctypes.Structure):
+    _fields_ = [
+        ("number", ctypes.c_int32),
+        ("fill", ctypes.c_uint32),
+        ("note", ctypes.c_char_p),
+    ]
+
+
+class Event(ctypes.Structure):
+    _fields_ = [
+        ("cell", ctypes.c_int32),
+        ("start_minutes", ctypes.c_int32),
+        ("duration_minutes", ctypes.c_int32),
+        ("fill", ctypes.c_uint32),
+        ("text", ctypes.c_uint32),
+        ("label", ctypes.c_char_p),
+    ]
+
+
+# The named colours the calendar views use, as 0xRRGGBB
+COLORS = {
+    "black": 0x000000, "white": 0xFFFFFF, "lightgrey": 0xD3D3D3, "salmon": 0xFA8072, "darkred": 0x8B0000,
+    "blue": 0x0000FF, "navy": 0x000080, "darkcyan": 0x008B8B, "cyan": 0x00FFFF, "teal": 0x008080,
+    "green": 0x008000, "darkgreen": 0x006400, "olive": 0x808000, "red": 0xFF0000, "brown": 0xA52A2A,
+    "orange": 0xFFA500, "darkorange": 0xFF8C00, "pink": 0xFFC0CB, "magenta": 0xFF00FF,
+    "purple": 0x800080, "darkviolet": 0x9400D3,
+}
+
+
+def _load():
+    path = os.environ.get("SCHEDULER_LIB") or os.path.join(os.path.dirname(os.path.abspath(__file__)), "libscheduler.so")
+    lib = ctypes.CDLL(path)
+    handle = ctypes.c_void_p
+    signatures = {
+        "sched_api_version": (ctypes.c_int, []),
+        "sched_configure_grid": (ctypes.c_int, [ctypes.c_int] * 6),
+        "sched_slot_count": (ctypes.c_int, []),
+        "sched_slot_minutes": (ctypes.c_int, [ctypes.c_int]),
+        "sched_create": (handle, [ctypes.c_int, ctypes.c_int]),
+        "sched_destroy": (None, [handle]),
+        "sched_seed": (None, [handle, ctypes.c_uint64]),
+        "sched_reserve": (ctypes.c_int, [handle, ctypes.c_int, ctypes.c_int, ctypes.c_int]),
+        "sched_block_day": (ctypes.c_int, [handle, ctypes.c_int, ctypes.c_int]),
+        "sched_set_start": (ctypes.c_int, [handle, ctypes.c_int, ctypes.c_int, ctypes.c_int]),
+        "sched_add_holiday": (ctypes.c_int, [handle, ctypes.c_int, ctypes.c_int, ctypes.c_int]),
+        "sched_set_holiday_policy": (ctypes.c_int, [handle, ctypes.c_int]),
+        "sched_add": (ctypes.c_int, [handle, ctypes.c_char_p, ctypes.c_char_p, ctypes.c_int, ctypes.c_int,
+                                     ctypes.c_int, ctypes.c_int, ctypes.POINTER(ctypes.c_int), ctypes.c_int]),
+        "sched_add_batch": (ctypes.c_int, [handle, ctypes.POINTER(MeetingRequest), ctypes.c_int,
+                                           ctypes.POINTER(ctypes.c_int)]),
+        "sched_place": (ctypes.c_int, [handle, ctypes.c_char_p, ctypes.c_char_p, ctypes.c_int, ctypes.c_int,
+                                       ctypes.c_int, ctypes.c_int, ctypes.c_int]),
+        "sched_remove": (ctypes.c_int, [handle, ctypes.c_int]),
+        "sched_free_slots": (ctypes.c_int, [handle, ctypes.c_int, ctypes.c_int, ctypes.c_int, ctypes.c_int,
+                                            ctypes.POINTER(ctypes.c_int), ctypes.c_int,
+                                            ctypes.POINTER(FreeSlot), ctypes.c_int]),
+        "sched_series_count": (ctypes.c_int, [handle]),
+        "sched_series_name": (ctypes.c_char_p, [handle, ctypes.c_int]),
+        "sched_series_type": (ctypes.c_char_p, [handle, ctypes.c_int]),
+        "sched_occurrence_count": (ctypes.c_int, [handle]),
+        "sched_occurrences": (ctypes.c_int, [handle, ctypes.POINTER(Occurrence), ctypes.c_int]),
+        "sched_occurrences_between": (ctypes.c_int, [handle, ctypes.c_int, ctypes.c_int,
+                                                     ctypes.POINTER(Occurrence), ctypes.c_int]),
+        "sched_series_clash": (ctypes.c_int, [handle, ctypes.c_int, ctypes.c_int]),
+        "sched_export_ics": (ctypes.c_int, [handle, ctypes.c_char_p]),
+        "sched_format_schedule": (ctypes.c_long, [handle, ctypes.c_int, ctypes.POINTER(ctypes.c_void_p)]),
+        "sched_render_month": (ctypes.c_long, [ctypes.c_char_p, ctypes.c_int, ctypes.POINTER(Cell),
+                                               ctypes.POINTER(Event), ctypes.c_int, ctypes.c_int, ctypes.c_int,
+                                               ctypes.c_int, ctypes.c_int, ctypes.POINTER(ctypes.c_void_p)]),
+        "sched_free": (None, [ctypes.c_void_p]),
+    }
+    for name, (restype, argtypes) in signatures.items():
+        func = getattr(lib, name)
+        func.restype = restype
+        func.argtypes = argtypes
+    if lib.sched_api_version() != API_VERSION:
+        raise ImportError(f"{path} implements scheduler API {lib.sched_api_version()}, expected {API_VERSION}")
+    return lib
+
+
+_lib = _load()
+
+
+def _slot_starts():
+    """Start of every slot of the current grid, in minutes after midnight."""
+    return [_lib.sched_slot_minutes(s) for s in range(_lib.sched_slot_count())]
+
+
+def configure_grid(slot_minutes=30, day_start=9 * 60, day_end=17 * 60, break_start=12 * 60, break_end=13 * 60,
+                   max_meeting_minutes=90):
+    """Sets the process-wide time grid; call it before creating any Scheduler."""
+    global SLOT_MINUTES
+    if not _lib.sched_configure_grid(slot_minutes, day_start, day_end, break_start, break_end, max_meeting_minutes):
+        raise ValueError("Invalid time grid")
+    SLOT_MINUTES = _slot_starts()
+
+
+def _frequency(frequency):
+    """FREQUENCIES value of a frequency name or value; ValueError for anything else."""
+    value = FREQUENCIES.get(frequency, frequency)
+    if not isinstance(value, int) or value not in FREQUENCIES.values():
+        raise ValueError(f"Unknown frequency {frequency!r}")
+    return value
+
+
+def _color(color):
+    return COLORS[color] if isinstance(color, str) else color
+
+
+def render_month(title, weeks, cells, events, day_start=9 * 60, day_end=17 * 60, bar_minutes=0, image_format="svg"):
+    """Draws a Monday-first month grid and returns the SVG text or PNG bytes.
+
+    cells holds weeks * 7 (day number or 0, fill, note or None) tuples and events
+    (cell, start minutes, duration minutes, fill, text colour, label) tuples;
+    colours are COLORS names or 0xRRGGBB values.
+    """
+    if len(cells) != weeks * 7:
+        raise ValueError(f"Expected {weeks * 7} cells, got {len(cells)}")
+    cell_array = (Cell * len(cells))(*[Cell(number, _color(fill), note.encode() if note else None)
+                                       for number, fill, note in cells])
+    event_array = (Event * max(len(events), 1))(*[Event(cell, start, duration, _color(fill), _color(text), label.encode())
+                                                  for cell, start, duration, fill, text, label in events])
+    image = ctypes.c_void_p()
+    size = _lib.sched_render_month(title.encode(), weeks, cell_array, event_array, len(events), day_start, day_end,
+                                   bar_minutes, 1 if image_format == "png" else 0, ctypes.byref(image))
+    if size < 0:
+        raise ValueError("Cannot render this month view")
+    try:
+        data = ctypes.string_at(image, size)
+    finally:
+        _lib.sched_free(image)
+    return data if image_format == "png" else data.decode()
+
+
+SLOT_MINUTES = _slot_starts()
+
+
+class Scheduler:
+    """One native scheduler; close() it, or use it as a context manager."""
+
+    def __init__(self, weeks, days, seed=None):
+        self._handle = _lib.sched_create(weeks, days)
+        if not self._handle:
+            raise ValueError(f"Cannot create a {weeks}-week, {days}-day scheduler")
+        if seed is not None:
+            _lib.sched_seed(self._handle, seed)
+
+    def close(self):
+        if self._handle:
+            _lib.sched_destroy(self._handle)
+            self._handle = None
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+    def __del__(self):
+        self.close()
+
+    def reserve(self, day, slot, duration_minutes):
+        """Blocks a slot run on `day` in every week; False on a clash."""
+        status = _lib.sched_reserve(self._handle, day, slot, duration_minutes)
+        if status == SCHED_ERR_MEMORY:
+            raise MemoryError("Cannot store the reservation")
+        return status == 1
+
+    def block_day(self, week, day):
+        return bool(_lib.sched_block_day(self._handle, week, day))
+
+    def set_start(self, date):
+        """Starts week 0 on the Monday on or before a datetime.date; drops holidays added so far."""
+        return bool(_lib.sched_set_start(self._handle, date.year, date.month, date.day))
+
+    def add_holidays(self, dates, shift=False):
+        """Marks dates as holidays and returns how many fall within the horizon.
+
+        Occurrences on a holiday are skipped, or with shift=True moved to the
+        next free working day of the same week.
+        """
+        _lib.sched_set_holiday_policy(self._handle, 1 if shift else 0)
+        return sum(_lib.sched_add_holiday(self._handle, d.year, d.month, d.day) for d in dates)
+
+    def add(self, name, meeting_type, duration_minutes, frequency, day=None, slot=None, preferred=()):
+        """Places a series and returns its index, or None when it does not fit.
+
+        frequency is a FREQUENCIES key or value; preferred lists slots to try first.
+        """
+        frequency = _frequency(frequency)
+        preferred = list(preferred)[:8]
+        slots = (ctypes.c_int * len(preferred))(*preferred)
+        series = _lib.sched_add(self._handle, name.encode(), meeting_type.encode(), duration_minutes, frequency,
+                                -1 if day is None else day, -1 if slot is None else slot, slots, len(preferred))
+        if series == SCHED_ERR_MEMORY:
+            raise MemoryError(f"Cannot store {name}")
+        return None if series < 0 else series
+
+    def add_all(self, meetings):
+        """Places a list of add() argument dicts together, least flexible first.
+
+        Returns each meeting's series index, or None where it did not fit, in list order.
+        """
+        requests = (MeetingRequest * len(meetings))()
+        for request, meeting in zip(requests, meetings):
+            preferred = list(meeting.get("preferred", ()))[:8]
+            day, slot = meeting.get("day"), meeting.get("slot")
+            request.name = meeting["name"].encode()
+            request.type = meeting["meeting_type"].encode()
+            request.duration_minutes = meeting["duration_minutes"]
+            request.frequency = _frequency(meeting["frequency"])
+            request.fixed_day = -1 if day is None else day
+            request.fixed_slot = -1 if slot is None else slot
+            request.preferred[:len(preferred)] = preferred
+            request.preferred_count = len(preferred)
+        series = (ctypes.c_int * len(meetings))()
+        if _lib.sched_add_batch(self._handle, requests, len(meetings), series) < 0:
+            raise MemoryError("Cannot place the meeting batch")
+        return [None if s < 0 else s for s in series]
+
+    def place(self, name, meeting_type, duration_minutes, frequency, day, slot, first_week):
+        """Records a series where add() placed it before; returns its index, or None on a clash."""
+        frequency = _frequency(frequency)
+        series = _lib.sched_place(self._handle, name.encode(), meeting_type.encode(), duration_minutes, frequency,
+                                  day, slot, first_week)
+        if series == SCHED_ERR_MEMORY:
+            raise MemoryError(f"Cannot store {name}")
+        return None if series < 0 else series
+
+    def free_slots(self, duration_minutes, frequency, day=None, slot=None, preferred=(), limit=5):
+        """Up to `limit` placements add() could make with these arguments, best balanced first.
+
+        Nothing is placed, so this is cheap enough for live suggestions.
+        """
+        frequency = _frequency(frequency)
+        preferred = list(preferred)[:8]
+        slots = (ctypes.c_int * len(preferred))(*preferred)
+        buffer = (FreeSlot * limit)()
+        count = _lib.sched_free_slots(self._handle, duration_minutes, frequency, -1 if day is None else day,
+                                      -1 if slot is None else slot, slots, len(preferred), buffer, limit)
+        return list(buffer[:count]) if count > 0 else []
+
+    def remove(self, series):
+        return bool(_lib.sched_remove(self._handle, series))
+
+    def series_name(self, series):
+        name = _lib.sched_series_name(self._handle, series)
+        return name.decode() if name is not None else None
+
+    def series_type(self, series):
+        name = _lib.sched_series_type(self._handle, series)
+        return name.decode() if name is not None else None
+
+    def occurrences(self):
+        """Every placed occurrence, grouped by series."""
+        count = _lib.sched_occurrence_count(self._handle)
+        buffer = (Occurrence * count)()
+        _lib.sched_occurrences(self._handle, buffer, count)
+        return list(buffer)
+
+    def occurrences_between(self, first_day, last_day):
+        """Occurrences on days first_day..last_day (inclusive, 0 is Monday of week 0), grouped by series."""
+        count = _lib.sched_occurrences_between(self._handle, first_day, last_day, None, 0)
+        buffer = (Occurrence * count)()
+        _lib.sched_occurrences_between(self._handle, first_day, last_day, buffer, count)
+        return list(buffer)
+
+    def clash(self, a, b):
+        """First week in which two series overlap, or None."""
+        week = _lib.sched_series_clash(self._handle, a, b)
+        return week if week >= 0 else None
+
+    def format_schedule(self, schedule_format="json"):
+        """The whole schedule as text, JSON or CSV (a SCHEDULE_FORMATS key), formatted in one pass."""
+        text = ctypes.c_void_p()
+        size = _lib.sched_format_schedule(self._handle, SCHEDULE_FORMATS[schedule_format], ctypes.byref(text))
+        if size < 0:
+            raise MemoryError("Cannot format the schedule")
+        try:
+            return ctypes.string_at(text, size).decode()
+        finally:
+            _lib.sched_free(text)
+
+    def export_ics(self, path):
+        return bool(_lib.sched_export_ics(self._handle, path.encode()))
@@ -0,0 +1,410 @@
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "scheduler_core.h"
+#include "intern.h"
+#include "outbuf.h"
+#include "schedulerd.h"
+
+// Resident scheduler daemon: see schedulerd.h for the protocol. Each worker
+// thread accepts a connection and serves it until the client hangs up, so up
+// to --workers clients are served at once and the rest wait in the backlog.
+
+#define DEFAULT_SOCKET "schedulerd.sock"
+#define RESPONSE_CAPACITY 4096
+#define OPS "CDRBAXQSE" // Every SchedOp
+#define REGISTRY_ARENA_BLOCK (64 * 1024)
+
+typedef struct {
+    pthread_mutex_t lock; // Held for every request on this calendar
+    SchedulerHandle *handle; // NULL until created and after a drop
+} Calendar;
+
+// Calendars are indexed by the intern id of their name. Entries are never
+// freed, so a worker may keep using one after the registry lock is released.
+typedef struct {
+    pthread_mutex_t lock; // Guards names and calendars
+    Arena arena;
+    InternTable names;
+    Store calendars;
+} Registry;
+
+static Registry registry;
+static const char *socket_path = DEFAULT_SOCKET;
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s [--socket PATH] [--workers N]\n"
+                    "          [--grid slot=MIN,start=HH:MM,end=HH:MM,break=HH:MM-HH:MM,max=MIN]\n", prog);
+}
+
+static Calendar *find_calendar(const char *name) {
+    pthread_mutex_lock(&registry.lock);
+    uint32_t id = intern_find(&registry.names, name);
+    Calendar *calendar = id == INTERN_NONE ? NULL : store_at(&registry.calendars, (int)id);
+    pthread_mutex_unlock(&registry.lock);
+    return calendar;
+}
+
+static int create_calendar(const char *name, int weeks, int days, const uint64_t *seed) {
+    pthread_mutex_lock(&registry.lock);
+    uint32_t id = intern_find(&registry.names, name);
+    if (id == INTERN_NONE) {
+        // The calendar entry comes first so every registered name has one
+        int index = registry.calendars.count;
+        Calendar *fresh = store_push(&registry.calendars);
+        if (fresh) id = intern_string(&registry.names, name);
+        if (id == INTERN_NONE) {
+            store_truncate(&registry.calendars, index);
+            pthread_mutex_unlock(&registry.lock);
+            return SCHEDD_ERR_RESOURCES;
+        }
+        pthread_mutex_init(&fresh->lock, NULL);
+        fresh->handle = NULL;
+    }
+    Calendar *calendar = store_at(&registry.calendars, (int)id);
+    pthread_mutex_lock(&calendar->lock);
+    pthread_mutex_unlock(&registry.lock);
+
+    int status = 1;
+    if (calendar->handle) {
+        status = SCHEDD_ERR_EXISTS;
+    } else if (weeks < 1 || weeks > MAX_HORIZON_WEEKS || days < 1 || days > MAX_DAYS) {
+        status = SCHEDD_ERR_REJECTED;
+    } else if (!(calendar->handle = sched_create(weeks, days))) {
+        status = SCHEDD_ERR_RESOURCES;
+    } else if (seed) {
+        sched_seed(calendar->handle, *seed);
+    }
+    pthread_mutex_unlock(&calendar->lock);
+    return status;
+}
+
+// Bounds-checked cursor over a request payload
+typedef struct {
+    const char *p;
+    const char *end;
+    bool ok;
+} Reader;
+
+static int32_t read_i32(Reader *in) {
+    int32_t value = 0;
+    if (in->end - in->p < (long)sizeof(value)) {
+        in->ok = false;
+        return 0;
+    }
+    memcpy(&value, in->p, sizeof(value));
+    in->p += sizeof(value);
+    return value;
+}
+
+static const char *read_string(Reader *in) {
+    const char *str = in->p;
+    const char *nul = memchr(in->p, '\0', (size_t)(in->end - in->p));
+    if (!nul) {
+        in->ok = false;
+        return "";
+    }
+    in->p = nul + 1;
+    return str;
+}
+
+// Up to 8 preferred slots of a `count`-long list; the rest are read and dropped
+static void read_preferred(Reader *in, int *preferred, int count) {
+    for (int i = 0; in->ok && i < count; i++) {
+        int slot = read_i32(in);
+        if (i < 8) preferred[i] = slot;
+    }
+}
+
+static void put_i32(OutBuf *out, int32_t value) {
+    outbuf_write(out, (const char *)&value, sizeof(value));
+}
+
+// QUERY data: the occurrences, then every series' name and type
+static void put_query(OutBuf *out, const SchedulerHandle *handle) {
+    int count = sched_occurrence_count(handle);
+    size_t size = (size_t)count * sizeof(SchedOccurrence);
+    outbuf_reserve(out, size);
+    if (out->failed) return;
+    sched_occurrences(handle, (SchedOccurrence *)(out->data + out->len), count);
+    out->len += size;
+
+    int series = sched_series_count(handle);
+    put_i32(out, series);
+    for (int i = 0; i < series; i++) {
+        const char *name = sched_series_name(handle, i);
+        const char *type = sched_series_type(handle, i);
+        outbuf_write(out, name ? name : "", name ? strlen(name) + 1 : 1);
+        outbuf_write(out, type ? type : "", type ? strlen(type) + 1 : 1);
+    }
+}
+
+// SUGGEST data: the suggested slots, written straight into the response
+static int put_suggestions(OutBuf *out, const SchedulerHandle *handle, int minutes, int frequency,
+                           int fixed_day, int fixed_slot, const int *preferred, int preferred_count, int capacity) {
+    if (capacity > MAX_DAYS * MAX_SLOTS) capacity = MAX_DAYS * MAX_SLOTS; // One per day and start at most
+    outbuf_reserve(out, (size_t)capacity * sizeof(SchedSlot));
+    if (out->failed) return SCHEDD_ERR_RESOURCES;
+    int count = sched_free_slots(handle, minutes, frequency, fixed_day, fixed_slot, preferred, preferred_count,
+                                 (SchedSlot *)(out->data + out->len), capacity);
+    if (count < 0) return SCHEDD_ERR_REJECTED;
+    out->len += (size_t)count * sizeof(SchedSlot);
+    return count;
+}
+
+static bool put_export(OutBuf *out, const SchedulerHandle *handle) {
+    char *text = NULL;
+    size_t size = 0;
+    FILE *fp = open_memstream(&text, &size);
+    if (!fp) return false;
+    bool ok = sched_write_ics(handle, fp);
+    ok = fclose(fp) == 0 && ok;
+    if (ok) outbuf_write(out, text, size);
+    free(text);
+    return ok;
+}
+
+// Runs one request against a locked calendar and returns its status. QUERY
+// and EXPORT append their data to `out`.
+static int run_op(int op, Reader *in, SchedulerHandle *handle, OutBuf *out) {
+    switch (op) {
+    case SCHEDD_DROP:
+        sched_destroy(handle);
+        return 1;
+    case SCHEDD_RESERVE: {
+        int day = read_i32(in), slot = read_i32(in), minutes = read_i32(in);
+        if (!in->ok) return SCHEDD_ERR_REJECTED;
+        int status = sched_reserve(handle, day, slot, minutes);
+        return status == 1 ? 1 : status == SCHED_ERR_MEMORY ? SCHEDD_ERR_RESOURCES : SCHEDD_ERR_REJECTED;
+    }
+    case SCHEDD_BLOCK: {
+        int week = read_i32(in), day = read_i32(in);
+        return in->ok && sched_block_day(handle, week, day) ? 1 : SCHEDD_ERR_REJECTED;
+    }
+    case SCHEDD_ADD: {
+        int minutes = read_i32(in), frequency = read_i32(in);
+        int fixed_day = read_i32(in), fixed_slot = read_i32(in), count = read_i32(in);
+        int preferred[8];
+        read_preferred(in, preferred, count);
+        const char *name = read_string(in);
+        const char *type = read_string(in);
+        if (!in->ok) return SCHEDD_ERR_MALFORMED;
+        int series = sched_add(handle, name, type, minutes, frequency, fixed_day, fixed_slot,
+                               preferred, count < 0 ? 0 : count < 8 ? count : 8);
+        return series >= 0 ? series : series == SCHED_ERR_MEMORY ? SCHEDD_ERR_RESOURCES : SCHEDD_ERR_REJECTED;
+    }
+    case SCHEDD_REMOVE: {
+        int series = read_i32(in);
+        return in->ok && sched_remove(handle, series) ? 1 : SCHEDD_ERR_REJECTED;
+    }
+    case SCHEDD_SUGGEST: {
+        int minutes = read_i32(in), frequency = read_i32(in);
+        int fixed_day = read_i32(in), fixed_slot = read_i32(in), count = read_i32(in);
+        int preferred[8];
+        read_preferred(in, preferred, count);
+        int capacity = read_i32(in);
+        if (!in->ok || capacity < 0) return SCHEDD_ERR_MALFORMED;
+        return put_suggestions(out, handle, minutes, frequency, fixed_day, fixed_slot,
+                               preferred, count < 0 ? 0 : count < 8 ? count : 8, capacity);
+    }
+    case SCHEDD_QUERY:
+        put_query(out, handle);
+        return sched_occurrence_count(handle);
+    case SCHEDD_EXPORT:
+        return put_export(out, handle) ? 1 : SCHEDD_ERR_RESOURCES;
+    }
+    return SCHEDD_ERR_MALFORMED;
+}
+
+static int run_request(int op, const char *name, Reader *in, OutBuf *out) {
+    if (op == SCHEDD_CREATE) {
+        int weeks = read_i32(in), days = read_i32(in);
+        uint64_t seed;
+        bool seeded = in->end - in->p >= (long)sizeof(seed);
+        if (seeded) memcpy(&seed, in->p, sizeof(seed));
+        return in->ok ? create_calendar(name, weeks, days, seeded ? &seed : NULL) : SCHEDD_ERR_MALFORMED;
+    }
+    Calendar *calendar = find_calendar(name);
+    if (!calendar) return SCHEDD_ERR_UNKNOWN;
+    pthread_mutex_lock(&calendar->lock);
+    int status = SCHEDD_ERR_UNKNOWN;
+    if (calendar->handle) {
+        status = run_op(op, in, calendar->handle, out);
+        if (op == SCHEDD_DROP) calendar->handle = NULL;
+    }
+    pthread_mutex_unlock(&calendar->lock);
+    return in->ok ? status : SCHEDD_ERR_MALFORMED;
+}
+
+// Builds the response frame for one request payload in `out`
+static void handle_request(const char *payload, size_t size, OutBuf *out) {
+    int32_t header[2] = {0, 0}; // Frame length and status, filled in below
+    out->len = 0;
+    outbuf_write(out, (const char *)header, sizeof(header));
+
+    int status = SCHEDD_ERR_MALFORMED;
+    size_t name_len = size >= 2 ? (unsigned char)payload[1] : 0;
+    if (size >= 2 && size >= 2 + name_len && payload[0] && strchr(OPS, payload[0])) {
+        char name[SCHEDD_MAX_NAME + 1];
+        memcpy(name, payload + 2, name_len);
+        name[name_len] = '\0';
+        Reader in = {payload + 2 + name_len, payload + size, true};
+        status = run_request((unsigned char)payload[0], name, &in, out);
+    }
+    if (out->failed || out->len > SCHEDD_MAX_FRAME) status = SCHEDD_ERR_RESOURCES;
+    // Only successful QUERY, EXPORT and SUGGEST carry data
+    if (status < 0) out->len = sizeof(header);
+    out->failed = false;
+    header[0] = (int32_t)(out->len - sizeof(uint32_t));
+    header[1] = status;
+    memcpy(out->data, header, sizeof(header));
+}
+
+static bool read_full(int fd, void *buf, size_t size) {
+    char *p = buf;
+    while (size) {
+        ssize_t n = read(fd, p, size);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        size -= (size_t)n;
+    }
+    return true;
+}
+
+static bool write_full(int fd, const char *data, size_t size) {
+    while (size) {
+        ssize_t n = send(fd, data, size, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        data += n;
+        size -= (size_t)n;
+    }
+    return true;
+}
+
+// Serves requests until the client hangs up or sends an oversized frame
+static void serve(int fd, OutBuf *out) {
+    char *payload = NULL;
+    uint32_t capacity = 0, size;
+    while (read_full(fd, &size, sizeof(size)) && size <= SCHEDD_MAX_FRAME) {
+        if (size > capacity) {
+            char *grown = realloc(payload, size);
+            if (!grown) break;
+            payload = grown;
+            capacity = size;
+        }
+        if (!read_full(fd, payload, size)) break;
+        handle_request(payload, size, out);
+        if (!write_full(fd, out->data, out->len)) break;
+    }
+    free(payload);
+}
+
+static void *worker(void *arg) {
+    int listen_fd = *(int *)arg;
+    OutBuf out;
+    outbuf_init(&out, NULL, RESPONSE_CAPACITY);
+    if (out.failed) return NULL;
+    for (;;) {
+        int fd = accept(listen_fd, NULL, NULL);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            perror("accept");
+            break;
+        }
+        serve(fd, &out);
+        close(fd);
+    }
+    outbuf_free(&out);
+    return NULL;
+}
+
+static void stop(int sig) {
+    (void)sig;
+    unlink(socket_path);
+    _exit(0);
+}
+
+// Binds the socket, replacing a stale file but not a running daemon
+static int listen_socket(const char *path) {
+    struct sockaddr_un addr = {.sun_family = AF_UNIX};
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        printf("Error: socket path %s is too long\n", path);
+        return -1;
+    }
+    strcpy(addr.sun_path, path);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        perror("socket");
+        return -1;
+    }
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) == 0) {
+        printf("Error: a daemon is already listening on %s\n", path);
+        close(fd);
+        return -1;
+    }
+    close(fd);
+    unlink(path);
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(fd, SOMAXCONN) < 0) {
+        perror(path);
+        if (fd >= 0) close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int main(int argc, char *argv[]) {
+    long workers = sysconf(_SC_NPROCESSORS_ONLN);
+    GridConfig grid = *grid_config();
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--socket") == 0 && i + 1 < argc) {
+            socket_path = argv[++i];
+        } else if (strcmp(argv[i], "--workers") == 0 && i + 1 < argc) {
+            workers = atol(argv[++i]);
+        } else if (strcmp(argv[i], "--grid") == 0 && i + 1 < argc && parse_grid_config(argv[i + 1], &grid)) {
+            i++;
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (!configure_grid(&grid)) return 1;
+    if (workers < 1) workers = 1;
+
+    pthread_mutex_init(&registry.lock, NULL);
+    arena_init(&registry.arena, REGISTRY_ARENA_BLOCK);
+    if (!intern_init(&registry.names, &registry.arena)) {
+        fprintf(stderr, "Error: Out of memory\n");
+        return 1;
+    }
+    store_init(&registry.calendars, &registry.arena, sizeof(Calendar));
+
+    int listen_fd = listen_socket(socket_path);
+    if (listen_fd < 0) return 1;
+    signal(SIGINT, stop);
+    signal(SIGTERM, stop);
+
+    pthread_t *threads = malloc((size_t)workers * sizeof(pthread_t));
+    long started = 0;
+    while (threads && started < workers && pthread_create(&threads[started], NULL, worker, &listen_fd) == 0) {
+        started++;
+    }
+    if (!started) {
+        printf("Error: cannot start worker threads\n");
+        unlink(socket_path);
+        return 1;
+    }
+    fprintf(stderr, "schedulerd: listening on %s with %ld workers\n", socket_path, started);
+    for (long t = 0; t < started; t++) pthread_join(threads[t], NULL);
+    unlink(socket_path);
+    free(threads);
+    return 0;
+}
@@ -0,0 +1,58 @@
+#ifndef SCHEDULERD_H
+#define SCHEDULERD_H
+
+#include <stdint.h>
+#include "libscheduler.h"
+
+// Wire protocol of schedulerd, which keeps named schedulers resident and
+// serves them over a local Unix stream socket.
+//
+// Every message is one frame: a uint32 payload length, then the payload. All
+// integers are in host byte order, since both ends share the machine. A
+// connection may carry any number of requests; each gets one response, in order.
+//
+// Request payload:
+//   uint8 op, uint8 name length, the calendar name (no terminator),
+//   then the op's int32 arguments, then its strings, each NUL-terminated.
+//
+//   SCHEDD_CREATE   weeks, days [, uint64 seed]
+//   SCHEDD_DROP
+//   SCHEDD_RESERVE  day, slot, duration_minutes
+//   SCHEDD_BLOCK    week, day
+//   SCHEDD_ADD      duration_minutes, frequency, fixed_day, fixed_slot,
+//                   preferred_count, preferred[preferred_count]; name, type
+//   SCHEDD_REMOVE   series
+//   SCHEDD_SUGGEST  duration_minutes, frequency, fixed_day, fixed_slot,
+//                   preferred_count, preferred[preferred_count], capacity
+//   SCHEDD_QUERY
+//   SCHEDD_EXPORT
+//
+// Response payload: int32 status, then data for QUERY, SUGGEST and EXPORT. Failures are
+// negative SCHEDD_ERR_* codes; otherwise status is the libscheduler.h result
+// (the series index for ADD, 1 for the other edits). QUERY answers with the
+// occurrence count, then that many SchedOccurrence records, an int32 series
+// count and a NUL-terminated name and type per series (empty once removed).
+// SUGGEST answers with the count, then that many SchedSlot records, best
+// first; it places nothing. EXPORT answers 1 and the calendar as ICS text.
+#define SCHEDD_MAX_FRAME (1u << 24) // Requests are far smaller; this bounds EXPORT
+#define SCHEDD_MAX_NAME 255
+
+typedef enum {
+    SCHEDD_CREATE = 'C',
+    SCHEDD_DROP = 'D',
+    SCHEDD_RESERVE = 'R',
+    SCHEDD_BLOCK = 'B',
+    SCHEDD_ADD = 'A',
+    SCHEDD_REMOVE = 'X',
+    SCHEDD_QUERY = 'Q',
+    SCHEDD_SUGGEST = 'S',
+    SCHEDD_EXPORT = 'E'
+} SchedOp;
+
+#define SCHEDD_ERR_REJECTED -1 // Bad arguments, a clash, or the meeting does not fit
+#define SCHEDD_ERR_UNKNOWN -2 // No calendar by that name
+#define SCHEDD_ERR_EXISTS -3 // CREATE of a name already in use
+#define SCHEDD_ERR_MALFORMED -4 // Unknown op or truncated request
+#define SCHEDD_ERR_RESOURCES -5 // Out of memory
+
+#endif
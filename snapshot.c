@@ -0,0 +1,421 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "snapshot.h"
+#include "outbuf.h"
+
+#define SNAPSHOT_BYTE_ORDER 0x01020304u
+
+static const char SNAPSHOT_MAGIC[8] = {'M', 'S', 'C', 'H', 'S', 'N', 'A', 'P'};
+
+// Sections, in file order
+enum {
+    SNAP_OCCUPANCY, // SlotMask per (week, day)
+    SNAP_SERIES, // MeetingSeries
+    SNAP_EXCEPTIONS, // SeriesException
+    SNAP_ATTENDEES, // int, the attendee pool
+    SNAP_RESERVATIONS, // Reservation
+    SNAP_RESERVATION_NEXT, // int per reservation
+    SNAP_STRING_OFFSETS, // uint32_t per interned string
+    SNAP_STRING_DATA, // NUL-terminated strings
+    SNAP_STRING_SLOTS, // uint32_t hash slots
+    SNAP_PEOPLE_OFFSETS,
+    SNAP_PEOPLE_DATA,
+    SNAP_PEOPLE_SLOTS,
+    SNAP_PERSON_GRIDS, // SlotMask, one occupancy-shaped grid per person
+    SNAP_HOLIDAYS, // uint8_t day bits per week
+    SNAP_SECTION_COUNT
+};
+
+typedef struct {
+    uint64_t offset; // From the start of the file
+    uint64_t count;
+    uint32_t elem_size;
+    uint32_t reserved;
+} SnapshotSection;
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order; // SNAPSHOT_BYTE_ORDER as written by the saving machine
+    uint32_t week_count;
+    uint32_t day_count; // Days in use; grids are always MAX_DAYS wide
+    int32_t grid[6]; // GridConfig in use, field by field; slot indexes depend on it
+    uint32_t reserved_name;
+    uint32_t reserved_type;
+    int32_t reservation_head[MAX_DAYS];
+    uint64_t seed;
+    uint64_t rng_state;
+    int64_t start_date;
+    uint32_t holiday_count;
+    uint32_t holiday_policy;
+    double total_hours[MAX_DAYS];
+    double meeting_hours[MAX_DAYS];
+    uint64_t file_size;
+    SnapshotSection sections[SNAP_SECTION_COUNT];
+} SnapshotHeader;
+
+// The time grid in use, as stored in SnapshotHeader.grid
+static void grid_fields(int32_t fields[6]) {
+    const GridConfig *grid = grid_config();
+    fields[0] = grid->slot_minutes;
+    fields[1] = grid->day_start;
+    fields[2] = grid->day_end;
+    fields[3] = grid->break_start;
+    fields[4] = grid->break_end;
+    fields[5] = grid->max_meeting_minutes;
+}
+
+// --------------------
+// Saving
+// --------------------
+
+static size_t strings_size(const InternTable *table) {
+    size_t size = 0;
+    for (int id = 0; id < intern_count(table); id++) size += strlen(intern_lookup(table, (uint32_t)id)) + 1;
+    return size;
+}
+
+static void write_store(OutBuf *out, const Store *store) {
+    for (int k = 0; k < store->chunk_count; k++) {
+        int n = store->count - (k << STORE_CHUNK_SHIFT);
+        if (n <= 0) break;
+        if (n > STORE_CHUNK_SIZE) n = STORE_CHUNK_SIZE;
+        outbuf_write(out, (const char *)store->chunks[k], (size_t)n * store->elem_size);
+    }
+}
+
+static void write_string_offsets(OutBuf *out, const InternTable *table) {
+    uint32_t offset = 0;
+    for (int id = 0; id < intern_count(table); id++) {
+        outbuf_write(out, (const char *)&offset, sizeof(offset));
+        offset += (uint32_t)strlen(intern_lookup(table, (uint32_t)id)) + 1;
+    }
+}
+
+static void write_string_data(OutBuf *out, const InternTable *table) {
+    for (int id = 0; id < intern_count(table); id++) {
+        const char *str = intern_lookup(table, (uint32_t)id);
+        outbuf_write(out, str, strlen(str) + 1);
+    }
+}
+
+static void set_section(SnapshotHeader *header, int id, uint64_t count, uint32_t elem_size) {
+    header->sections[id].count = count;
+    header->sections[id].elem_size = elem_size;
+}
+
+bool save_snapshot(const MeetingScheduler *scheduler, const char *path) {
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.byte_order = SNAPSHOT_BYTE_ORDER;
+    header.week_count = (uint32_t)scheduler->week_count;
+    header.day_count = (uint32_t)scheduler->day_count;
+    grid_fields(header.grid);
+    header.reserved_name = scheduler->reserved_name;
+    header.reserved_type = scheduler->reserved_type;
+    for (int d = 0; d < MAX_DAYS; d++) {
+        header.reservation_head[d] = scheduler->reservation_head[d];
+        header.total_hours[d] = scheduler->total_hours[d];
+        header.meeting_hours[d] = scheduler->meeting_hours[d];
+    }
+    header.seed = scheduler->seed;
+    header.rng_state = scheduler->rng_state;
+    header.start_date = scheduler->start_date;
+    header.holiday_count = (uint32_t)scheduler->holiday_count;
+    header.holiday_policy = (uint32_t)scheduler->holiday_policy;
+
+    size_t cells = (size_t)scheduler->week_count * MAX_DAYS;
+    set_section(&header, SNAP_OCCUPANCY, cells, sizeof(SlotMask));
+    set_section(&header, SNAP_SERIES, scheduler->series.count, sizeof(MeetingSeries));
+    set_section(&header, SNAP_EXCEPTIONS, scheduler->exceptions.count, sizeof(SeriesException));
+    set_section(&header, SNAP_ATTENDEES, scheduler->attendee_pool.count, sizeof(int));
+    set_section(&header, SNAP_RESERVATIONS, scheduler->reservations.count, sizeof(Reservation));
+    set_section(&header, SNAP_RESERVATION_NEXT, scheduler->reservation_next.count, sizeof(int));
+    set_section(&header, SNAP_STRING_OFFSETS, intern_count(&scheduler->strings), sizeof(uint32_t));
+    set_section(&header, SNAP_STRING_DATA, strings_size(&scheduler->strings), 1);
+    set_section(&header, SNAP_STRING_SLOTS, scheduler->strings.slot_mask + 1, sizeof(uint32_t));
+    set_section(&header, SNAP_PEOPLE_OFFSETS, intern_count(&scheduler->people), sizeof(uint32_t));
+    set_section(&header, SNAP_PEOPLE_DATA, strings_size(&scheduler->people), 1);
+    set_section(&header, SNAP_PEOPLE_SLOTS, scheduler->people.slot_mask + 1, sizeof(uint32_t));
+    set_section(&header, SNAP_PERSON_GRIDS, cells * scheduler->person_grids.count, sizeof(SlotMask));
+    set_section(&header, SNAP_HOLIDAYS, scheduler->week_count, 1);
+    uint64_t offset = sizeof(header);
+    for (int id = 0; id < SNAP_SECTION_COUNT; id++) {
+        offset = (offset + SNAPSHOT_ALIGN - 1) & ~(uint64_t)(SNAPSHOT_ALIGN - 1);
+        header.sections[id].offset = offset;
+        offset += header.sections[id].count * header.sections[id].elem_size;
+    }
+    header.file_size = offset;
+
+    FILE *fp = fopen(path, "wb");
+    if (!fp) {
+        printf("Error: Cannot create %s\n", path);
+        return false;
+    }
+    OutBuf out;
+    outbuf_init(&out, fp, 0);
+    outbuf_write(&out, (const char *)&header, sizeof(header));
+    uint64_t written = sizeof(header);
+    static const char zeros[SNAPSHOT_ALIGN];
+    for (int id = 0; id < SNAP_SECTION_COUNT; id++) {
+        outbuf_write(&out, zeros, header.sections[id].offset - written);
+        switch (id) {
+            case SNAP_OCCUPANCY: outbuf_write(&out, (const char *)scheduler->occupancy, cells * sizeof(SlotMask)); break;
+            case SNAP_SERIES: write_store(&out, &scheduler->series); break;
+            case SNAP_EXCEPTIONS: write_store(&out, &scheduler->exceptions); break;
+            case SNAP_ATTENDEES: write_store(&out, &scheduler->attendee_pool); break;
+            case SNAP_RESERVATIONS: write_store(&out, &scheduler->reservations); break;
+            case SNAP_RESERVATION_NEXT: write_store(&out, &scheduler->reservation_next); break;
+            case SNAP_STRING_OFFSETS: write_string_offsets(&out, &scheduler->strings); break;
+            case SNAP_STRING_DATA: write_string_data(&out, &scheduler->strings); break;
+            case SNAP_STRING_SLOTS:
+                outbuf_write(&out, (const char *)scheduler->strings.slots,
+                             (scheduler->strings.slot_mask + 1) * sizeof(uint32_t));
+                break;
+            case SNAP_PEOPLE_OFFSETS: write_string_offsets(&out, &scheduler->people); break;
+            case SNAP_PEOPLE_DATA: write_string_data(&out, &scheduler->people); break;
+            case SNAP_PEOPLE_SLOTS:
+                outbuf_write(&out, (const char *)scheduler->people.slots,
+                             (scheduler->people.slot_mask + 1) * sizeof(uint32_t));
+                break;
+            case SNAP_PERSON_GRIDS:
+                for (int person = 0; person < scheduler->person_grids.count; person++) {
+                    outbuf_write(&out, (const char *)person_grid(scheduler, person), cells * sizeof(SlotMask));
+                }
+                break;
+            case SNAP_HOLIDAYS: outbuf_write(&out, (const char *)scheduler->holidays, scheduler->week_count); break;
+        }
+        written = header.sections[id].offset + header.sections[id].count * header.sections[id].elem_size;
+    }
+    bool ok = outbuf_flush(&out);
+    outbuf_free(&out);
+    if (fclose(fp) != 0) ok = false;
+    if (!ok) printf("Error: Failed to write %s\n", path);
+    return ok;
+}
+
+// --------------------
+// Loading
+// --------------------
+
+static const char *check_header(const SnapshotHeader *header, uint64_t file_size) {
+    static const uint32_t elem_sizes[SNAP_SECTION_COUNT] = {
+        sizeof(SlotMask), sizeof(MeetingSeries), sizeof(SeriesException), sizeof(int),
+        sizeof(Reservation), sizeof(int), sizeof(uint32_t), 1, sizeof(uint32_t), sizeof(uint32_t), 1,
+        sizeof(uint32_t), sizeof(SlotMask), 1
+    };
+    if (memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic)) != 0) return "not a scheduler snapshot";
+    if (header->version != SNAPSHOT_VERSION) return "unsupported snapshot version";
+    if (header->byte_order != SNAPSHOT_BYTE_ORDER) return "snapshot was written with another byte order";
+    if (header->day_count == 0 || header->day_count > MAX_DAYS) return "bad day count";
+    int32_t grid[6];
+    grid_fields(grid);
+    if (memcmp(header->grid, grid, sizeof(grid)) != 0) return "snapshot uses another time grid";
+    if (header->week_count == 0 || header->week_count > MAX_HORIZON_WEEKS) return "bad horizon";
+    if (header->holiday_policy > HOLIDAY_SHIFT) return "unknown holiday policy";
+    if (header->file_size != file_size) return "truncated snapshot";
+    uint64_t cells = (uint64_t)header->week_count * MAX_DAYS;
+    for (int id = 0; id < SNAP_SECTION_COUNT; id++) {
+        const SnapshotSection *section = &header->sections[id];
+        if (section->elem_size != elem_sizes[id]) return "snapshot was written with another layout";
+        if (section->offset % SNAPSHOT_ALIGN || section->count > INT32_MAX ||
+            section->offset + section->count * section->elem_size > file_size) {
+            return "section out of range";
+        }
+    }
+    const SnapshotSection *sections = header->sections;
+    if (sections[SNAP_OCCUPANCY].count != cells ||
+        sections[SNAP_RESERVATION_NEXT].count != sections[SNAP_RESERVATIONS].count ||
+        sections[SNAP_HOLIDAYS].count != header->week_count ||
+        sections[SNAP_PERSON_GRIDS].count != cells * sections[SNAP_PEOPLE_OFFSETS].count) {
+        return "inconsistent section sizes";
+    }
+    if (header->reserved_name >= sections[SNAP_STRING_OFFSETS].count ||
+        header->reserved_type >= sections[SNAP_STRING_OFFSETS].count) {
+        return "corrupt string table";
+    }
+    return NULL;
+}
+
+// Series rules are expanded into grid indexes, so each must stay inside the
+// horizon and the day's slots, and its exception and attendee runs inside
+// their sections
+static const char *check_series(const SnapshotHeader *header, const unsigned char *base) {
+    const SnapshotSection *sections = header->sections;
+    const MeetingSeries *series = (const MeetingSeries *)(base + sections[SNAP_SERIES].offset);
+    for (uint64_t i = 0; i < sections[SNAP_SERIES].count; i++) {
+        const MeetingSeries *s = &series[i];
+        if (s->period == 0 || s->day >= header->day_count || s->frequency >= FREQ_COUNT ||
+            s->start_time >= MAX_SLOTS || !(allowed_starts(s->duration) >> s->start_time & 1) ||
+            (s->occurrences && s->phase + (uint64_t)(s->occurrences - 1) * s->period >= header->week_count) ||
+            (uint64_t)s->first_exception + s->exception_count > sections[SNAP_EXCEPTIONS].count ||
+            (uint64_t)s->attendees + s->attendee_count > sections[SNAP_ATTENDEES].count ||
+            s->name >= sections[SNAP_STRING_OFFSETS].count || s->type >= sections[SNAP_STRING_OFFSETS].count) {
+            return "corrupt series table";
+        }
+    }
+    const int *pool = (const int *)(base + sections[SNAP_ATTENDEES].offset);
+    for (uint64_t i = 0; i < sections[SNAP_ATTENDEES].count; i++) {
+        if (pool[i] < 0 || (uint64_t)pool[i] >= sections[SNAP_PEOPLE_OFFSETS].count) return "corrupt series table";
+    }
+    const SeriesException *exceptions = (const SeriesException *)(base + sections[SNAP_EXCEPTIONS].offset);
+    for (uint64_t i = 0; i < sections[SNAP_EXCEPTIONS].count; i++) {
+        if (exceptions[i].week >= header->week_count ||
+            (exceptions[i].day >= header->day_count && exceptions[i].day != OCCURRENCE_DROPPED)) {
+            return "corrupt series table";
+        }
+    }
+    return NULL;
+}
+
+// Reservations index the grid and each day's list is walked to its end, so
+// every link must stay in range and every list must end within the table
+static const char *check_reservations(const SnapshotHeader *header, const unsigned char *base) {
+    const SnapshotSection *sections = header->sections;
+    const Reservation *reservations = (const Reservation *)(base + sections[SNAP_RESERVATIONS].offset);
+    const int *next = (const int *)(base + sections[SNAP_RESERVATION_NEXT].offset);
+    int64_t count = (int64_t)sections[SNAP_RESERVATIONS].count;
+    for (int64_t i = 0; i < count; i++) {
+        const Reservation *res = &reservations[i];
+        if (res->day < 0 || (uint32_t)res->day >= header->day_count || res->start_time < 0 ||
+            res->start_time >= MAX_SLOTS || !(allowed_starts(res->duration) >> res->start_time & 1) ||
+            next[i] < -1 || next[i] >= count) {
+            return "corrupt reservation table";
+        }
+    }
+    for (int d = 0; d < MAX_DAYS; d++) {
+        int64_t steps = 0;
+        for (int i = header->reservation_head[d]; i != -1; i = next[i]) {
+            if (i < -1 || i >= count || reservations[i].day != d || ++steps > count) return "corrupt reservation table";
+        }
+    }
+    return NULL;
+}
+
+// Checks one saved intern table and maps it into `table`; false when it is
+// corrupt or the arena is out of memory
+static bool map_strings(InternTable *table, Arena *arena, unsigned char *base, const SnapshotSection *offsets,
+                        const SnapshotSection *data, const SnapshotSection *slots) {
+    const uint32_t *offset_array = (const uint32_t *)(base + offsets->offset);
+    const char *chars = (const char *)(base + data->offset);
+    uint64_t slot_count = slots->count;
+    if (slot_count < 2 || (slot_count & (slot_count - 1)) || slot_count > UINT32_MAX) return false;
+    if (offsets->count && (data->count == 0 || chars[data->count - 1] != '\0')) return false;
+    for (uint64_t i = 0; i < offsets->count; i++) {
+        if (offset_array[i] >= data->count) return false;
+    }
+    // Slots hold id + 1, and probing stops at the first empty one
+    const uint32_t *slot_array = (const uint32_t *)(base + slots->offset);
+    uint64_t used = 0;
+    for (uint64_t i = 0; i < slot_count; i++) {
+        if (slot_array[i] > offsets->count) return false;
+        used += slot_array[i] != 0;
+    }
+    if (used == slot_count) return false;
+    return intern_map(table, arena, offset_array, chars, (int)offsets->count, (uint32_t *)(base + slots->offset),
+                      (uint32_t)slot_count);
+}
+
+bool load_snapshot(MeetingScheduler *scheduler, const char *path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        printf("Error: Cannot open %s\n", path);
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(SnapshotHeader)) {
+        close(fd);
+        printf("Error: %s: not a scheduler snapshot\n", path);
+        return false;
+    }
+    // Private and writable: the loaded scheduler edits pages in place without touching the file
+    void *mapping = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        printf("Error: Cannot map %s\n", path);
+        return false;
+    }
+    unsigned char *base = mapping;
+    const SnapshotHeader *header = mapping;
+    const SnapshotSection *sections = header->sections;
+    const char *problem = check_header(header, (uint64_t)st.st_size);
+    if (!problem) problem = check_series(header, base);
+    if (!problem) problem = check_reservations(header, base);
+    if (problem) {
+        printf("Error: %s: %s\n", path, problem);
+        munmap(mapping, (size_t)st.st_size);
+        return false;
+    }
+
+    arena_init(&scheduler->arena, SCHEDULER_ARENA_BLOCK);
+    Arena *arena = &scheduler->arena;
+    if (!map_strings(&scheduler->strings, arena, base, &sections[SNAP_STRING_OFFSETS],
+                     &sections[SNAP_STRING_DATA], &sections[SNAP_STRING_SLOTS]) ||
+        !map_strings(&scheduler->people, arena, base, &sections[SNAP_PEOPLE_OFFSETS],
+                     &sections[SNAP_PEOPLE_DATA], &sections[SNAP_PEOPLE_SLOTS])) {
+        printf(arena->failed ? "Error: %s: out of memory\n" : "Error: %s: corrupt string table\n", path);
+        arena_free(arena);
+        munmap(mapping, (size_t)st.st_size);
+        return false;
+    }
+    scheduler->mapping = mapping;
+    scheduler->mapping_size = (size_t)st.st_size;
+    scheduler->week_count = (int)header->week_count;
+    scheduler->day_count = (int)header->day_count;
+    scheduler->reserved_name = header->reserved_name;
+    scheduler->reserved_type = header->reserved_type;
+    for (int d = 0; d < MAX_DAYS; d++) {
+        scheduler->reservation_head[d] = header->reservation_head[d];
+        scheduler->total_hours[d] = header->total_hours[d];
+        scheduler->meeting_hours[d] = header->meeting_hours[d];
+    }
+    sort_day_loads(scheduler);
+    scheduler->seed = header->seed;
+    scheduler->rng_state = header->rng_state;
+    scheduler->start_date = (long)header->start_date;
+    scheduler->holiday_count = (int)header->holiday_count;
+    scheduler->holiday_policy = (HolidayPolicy)header->holiday_policy;
+    scheduler->holidays = base + sections[SNAP_HOLIDAYS].offset;
+
+    scheduler->occupancy = (SlotMask *)(base + sections[SNAP_OCCUPANCY].offset);
+    static const struct {
+        int section;
+        size_t store;
+    } stores[] = {
+        {SNAP_SERIES, offsetof(MeetingScheduler, series)},
+        {SNAP_EXCEPTIONS, offsetof(MeetingScheduler, exceptions)},
+        {SNAP_ATTENDEES, offsetof(MeetingScheduler, attendee_pool)},
+        {SNAP_RESERVATIONS, offsetof(MeetingScheduler, reservations)},
+        {SNAP_RESERVATION_NEXT, offsetof(MeetingScheduler, reservation_next)},
+    };
+    bool ok = true;
+    for (size_t i = 0; i < sizeof(stores) / sizeof(stores[0]) && ok; i++) {
+        const SnapshotSection *section = &sections[stores[i].section];
+        ok = store_map((Store *)((char *)scheduler + stores[i].store), arena, section->elem_size,
+                       base + section->offset, (int)section->count);
+    }
+
+    size_t cells = (size_t)scheduler->week_count * MAX_DAYS;
+    SlotMask *grids = (SlotMask *)(base + sections[SNAP_PERSON_GRIDS].offset);
+    store_init(&scheduler->person_grids, arena, sizeof(SlotMask *));
+    for (uint64_t person = 0; person < sections[SNAP_PEOPLE_OFFSETS].count && ok; person++) {
+        SlotMask **entry = store_push(&scheduler->person_grids);
+        if (entry) *entry = grids + person * cells;
+        ok = entry != NULL;
+    }
+    scheduler->week_starts = arena_alloc(arena, scheduler->week_count * sizeof(SlotMask));
+    scheduler->busy = arena_alloc(arena, cells * sizeof(SlotMask));
+    if (!ok || !scheduler->week_starts || !scheduler->busy) {
+        printf("Error: %s: out of memory\n", path);
+        free_scheduler(scheduler);
+        return false;
+    }
+    return true;
+}
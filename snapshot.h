@@ -0,0 +1,25 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "scheduler_core.h"
+
+// Binary snapshot of the full scheduler state.
+//
+// The file is a fixed header followed by sections, each a raw array aligned
+// to SNAPSHOT_ALIGN: occupancy, series and their holiday exceptions,
+// attendee pool, reservations and their links, both intern tables (offsets,
+// string data, hash slots), the person grids and the holiday bitmap.
+// Every cross-reference in these arrays is an index, so load_snapshot maps
+// the file copy-on-write and points the stores straight at it; only the
+// string and person-grid pointer tables are rebuilt. The header records the
+// version, byte order, element sizes and time grid, and a file that does not
+// match is rejected rather than converted.
+#define SNAPSHOT_VERSION 5
+#define SNAPSHOT_ALIGN 64
+
+bool save_snapshot(const MeetingScheduler *scheduler, const char *path);
+
+// Initialises `scheduler` from a snapshot; on failure it is left uninitialised
+bool load_snapshot(MeetingScheduler *scheduler, const char *path);
+
+#endif
@@ -0,0 +1,420 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "solver.h"
+
+#define WEEKLY_CAP_HOURS 2.5
+
+typedef struct {
+    uint8_t day;
+    uint8_t start;
+    uint8_t phase;
+} SolverValue;
+
+typedef struct {
+    const Meeting *meeting;
+    int fixed_day; // -1 when any day will do
+    int duration;
+    int period;
+    int occurrences;
+    int phases; // First weeks the series can start in, as add_meeting counts them
+    double hours; // Meeting hours the placement adds to its day
+    int first; // Values of this meeting are values[first .. first + count)
+    int count;
+    int alive; // Values still in the domain
+    int assigned; // Index into values, or -1
+} SolverVar;
+
+typedef struct {
+    MeetingScheduler *scheduler;
+    SolverVar *vars;
+    int var_count;
+    SolverValue *values;
+    int *pruned_at; // Depth that removed each value, or -1 while alive
+    int *trail; // Pruned value indices, in pruning order
+    int trail_len;
+    int *order; // Variables in assignment order
+    double load[MAX_DAYS]; // Meeting hours per day
+    double largest[MAX_DAYS]; // Largest single placement per day made by the solver
+    uint8_t same_people[MAX_DAYS]; // Bit b of entry a: every attendee calendar matches on days a and b
+    double cap;
+    long max_nodes;
+    SolverStats *stats;
+} Solver;
+
+static inline int value_var(const Solver *solver, int v) {
+    // Values are laid out per variable; binary search over `first`
+    int lo = 0, hi = solver->var_count - 1;
+    while (lo < hi) {
+        int mid = (lo + hi + 1) / 2;
+        if (solver->vars[mid].first <= v) lo = mid;
+        else hi = mid - 1;
+    }
+    return lo;
+}
+
+static bool value_fits(const Solver *solver, const SolverVar *var, const SolverValue *value) {
+    SlotMask run = run_mask(value->start, var->duration);
+    for (int k = 0; k < var->occurrences; k++) {
+        int week = value->phase + k * var->period;
+        if (!is_holiday(solver->scheduler, week, value->day) &&
+            *occupancy_cell(solver->scheduler, week, value->day) & run) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// The cap is order-free: some placement order keeps every day at or under
+// the cap before each add exactly when load minus the largest add fits
+static bool value_within_cap(const Solver *solver, const SolverVar *var, const SolverValue *value) {
+    double load = solver->load[value->day] + var->hours;
+    double largest = solver->largest[value->day] > var->hours ? solver->largest[value->day] : var->hours;
+    return load - largest <= solver->cap;
+}
+
+static void apply_value(Solver *solver, const SolverVar *var, const SolverValue *value, bool on) {
+    SlotMask run = run_mask(value->start, var->duration);
+    for (int k = 0; k < var->occurrences; k++) {
+        int week = value->phase + k * var->period;
+        if (is_holiday(solver->scheduler, week, value->day)) continue;
+        SlotMask *cell = occupancy_cell(solver->scheduler, week, value->day);
+        *cell = on ? *cell | run : *cell & ~run;
+    }
+}
+
+// Builds the domain of one meeting: days (fixed or all) x starts (fixed,
+// preferred or all) x phases, keeping only values valid right now
+static int build_domain(Solver *solver, SolverVar *var, SolverValue *out) {
+    const Meeting *meeting = var->meeting;
+    int count = 0;
+    int fixed_day = var->fixed_day;
+    int fixed_time = meeting->fixed_time[0] ? find_slot_index(meeting->fixed_time) : -1;
+    if ((meeting->fixed_day[0] && fixed_day < 0) || (meeting->fixed_time[0] && fixed_time < 0)) return 0;
+    int starts[MAX_SLOTS];
+    int start_count = 0;
+    if (fixed_time >= 0) {
+        starts[start_count++] = fixed_time;
+    } else if (meeting->preferred_hours[0] >= 0) {
+        for (int i = 0; i < 8 && meeting->preferred_hours[i] >= 0; i++) {
+            if (meeting->preferred_hours[i] < slot_count()) starts[start_count++] = meeting->preferred_hours[i];
+        }
+    } else {
+        for (int t = 0; t < slot_count(); t++) starts[start_count++] = t;
+    }
+    SlotMask allowed = allowed_starts(var->duration);
+    // Attendee calendars do not change during the search, so they only filter the domain
+    const SlotMask *busy = meeting_busy(solver->scheduler, meeting);
+    for (int d = 0; d < solver->scheduler->day_count; d++) {
+        if (fixed_day >= 0 && d != fixed_day) continue;
+        for (int t = 0; t < start_count; t++) {
+            if (!(allowed >> starts[t] & 1)) continue;
+            for (int p = 0; p < var->phases; p++) {
+                SolverValue value = {(uint8_t)d, (uint8_t)starts[t], (uint8_t)p};
+                bool attendees_free = true;
+                for (int k = 0; k < var->occurrences && attendees_free; k++) {
+                    int week = p + k * var->period;
+                    attendees_free = is_holiday(solver->scheduler, week, d) || !(busy[(size_t)week * MAX_DAYS + d] & run_mask(starts[t], var->duration));
+                }
+                if (attendees_free && value_fits(solver, var, &value) && value_within_cap(solver, var, &value)) {
+                    out[count++] = value;
+                }
+            }
+        }
+    }
+    return count;
+}
+
+// Forward checking after `var` took `value`: drop neighbours' values that now
+// clash or would break the day cap. Returns false on a domain wipe-out.
+static bool propagate(Solver *solver, const SolverVar *var, const SolverValue *value, int depth) {
+    SlotMask run = run_mask(value->start, var->duration);
+    for (int u = 0; u < solver->var_count; u++) {
+        SolverVar *other = &solver->vars[u];
+        if (other->assigned >= 0) continue;
+        for (int i = other->first; i < other->first + other->count; i++) {
+            if (solver->pruned_at[i] >= 0) continue;
+            const SolverValue *candidate = &solver->values[i];
+            if (candidate->day != value->day) continue;
+            bool dead = !value_within_cap(solver, other, candidate);
+            if (!dead && (run_mask(candidate->start, other->duration) & run)) dead = !value_fits(solver, other, candidate);
+            if (dead) {
+                solver->pruned_at[i] = depth;
+                solver->trail[solver->trail_len++] = i;
+                if (--other->alive == 0) return false;
+            }
+        }
+    }
+    return true;
+}
+
+static void undo_pruning(Solver *solver, int mark) {
+    while (solver->trail_len > mark) {
+        int i = solver->trail[--solver->trail_len];
+        solver->pruned_at[i] = -1;
+        solver->vars[value_var(solver, i)].alive++;
+    }
+}
+
+// Most constrained first: fewest live values, then the most meeting hours
+static int pick_variable(const Solver *solver) {
+    int best = -1;
+    for (int u = 0; u < solver->var_count; u++) {
+        const SolverVar *var = &solver->vars[u];
+        if (var->assigned >= 0) continue;
+        if (best < 0) {
+            best = u;
+            continue;
+        }
+        const SolverVar *current = &solver->vars[best];
+        if (var->alive != current->alive ? var->alive < current->alive :
+            var->hours > current->hours) best = u;
+    }
+    return best;
+}
+
+// Relaxed capacity checks over everything still unassigned: total slots
+// against free slots, and total hours against what the day caps can absorb.
+// A day ends with load - largest <= cap, and each day's final largest is
+// either what it holds now or a distinct unassigned meeting, so the hours
+// still to place are bounded by the headroom plus the day_count biggest of
+// those candidates.
+static bool capacity_left(const Solver *solver) {
+    double hours = 0;
+    int days = solver->scheduler->day_count;
+    double top[2 * MAX_DAYS]; // Descending
+    int top_count = 0;
+    long slots = 0;
+    for (int u = -days; u < solver->var_count; u++) {
+        double candidate;
+        if (u < 0) {
+            candidate = solver->largest[u + days];
+        } else {
+            const SolverVar *var = &solver->vars[u];
+            if (var->assigned >= 0) continue;
+            hours += var->hours;
+            slots += (long)var->duration * var->occurrences;
+            candidate = var->hours;
+        }
+        if (top_count < 2 * days) top[top_count++] = candidate;
+        else if (candidate > top[top_count - 1]) top[top_count - 1] = candidate;
+        for (int i = top_count - 1; i > 0 && top[i] > top[i - 1]; i--) {
+            double swap = top[i];
+            top[i] = top[i - 1];
+            top[i - 1] = swap;
+        }
+    }
+    double room = 0;
+    for (int d = 0; d < days; d++) room += solver->cap - solver->load[d] + top[d];
+    if (hours > room + 1e-9) return false;
+    SlotMask all_slots = allowed_starts(1);
+    long free_slots = 0;
+    for (int w = 0; w < solver->scheduler->week_count && free_slots < slots; w++) {
+        for (int d = 0; d < days; d++) {
+            free_slots += __builtin_popcountll(all_slots & ~*occupancy_cell(solver->scheduler, w, d));
+        }
+    }
+    return slots <= free_slots;
+}
+
+// Attendee calendars do not change during the search, so the days they agree
+// on are worked out once
+static void match_person_days(Solver *solver) {
+    const MeetingScheduler *scheduler = solver->scheduler;
+    for (int a = 0; a < scheduler->day_count; a++) {
+        for (int b = 0; b < scheduler->day_count; b++) {
+            bool same = true;
+            for (int person = 0; person < scheduler->person_grids.count && same; person++) {
+                const SlotMask *grid = person_grid(scheduler, person);
+                for (int w = 0; w < scheduler->week_count && same; w++) {
+                    same = grid[(size_t)w * MAX_DAYS + a] == grid[(size_t)w * MAX_DAYS + b];
+                }
+            }
+            if (same) solver->same_people[a] |= (uint8_t)(1 << b);
+        }
+    }
+}
+
+// Two days are interchangeable for the rest of the search when their state,
+// attendee calendars included, is identical and no unassigned meeting is
+// pinned to either of them
+static bool days_interchangeable(const Solver *solver, int a, int b) {
+    if (!(solver->same_people[a] >> b & 1)) return false;
+    if (solver->load[a] != solver->load[b] || solver->largest[a] != solver->largest[b]) return false;
+    for (int u = 0; u < solver->var_count; u++) {
+        const SolverVar *var = &solver->vars[u];
+        if (var->assigned < 0 && (var->fixed_day == a || var->fixed_day == b)) return false;
+    }
+    for (int w = 0; w < solver->scheduler->week_count; w++) {
+        if (*occupancy_cell(solver->scheduler, w, a) != *occupancy_cell(solver->scheduler, w, b) ||
+            is_holiday(solver->scheduler, w, a) != is_holiday(solver->scheduler, w, b)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool search(Solver *solver, int depth) {
+    if (depth == solver->var_count) return true;
+    int u = pick_variable(solver);
+    SolverVar *var = &solver->vars[u];
+    if (var->alive == 0 || !capacity_left(solver)) return false;
+
+    // Try the least loaded days first, like add_meeting
+    int days = solver->scheduler->day_count;
+    int day_order[MAX_DAYS];
+    for (int i = 0; i < days; i++) day_order[i] = i;
+    for (int i = 1; i < days; i++) {
+        int d = day_order[i], j = i;
+        while (j > 0 && solver->load[day_order[j - 1]] > solver->load[d]) {
+            day_order[j] = day_order[j - 1];
+            j--;
+        }
+        day_order[j] = d;
+    }
+
+    for (int o = 0; o < days; o++) {
+        // A day identical to one already explored cannot lead anywhere new
+        bool duplicate = false;
+        for (int p = 0; p < o && !duplicate && var->fixed_day < 0; p++) {
+            duplicate = days_interchangeable(solver, day_order[p], day_order[o]);
+        }
+        if (duplicate) continue;
+        for (int i = var->first; i < var->first + var->count; i++) {
+            const SolverValue *value = &solver->values[i];
+            if (value->day != day_order[o] || solver->pruned_at[i] >= 0) continue;
+            if (solver->max_nodes && solver->stats->nodes >= solver->max_nodes) {
+                solver->stats->limit_hit = true;
+                return false;
+            }
+            solver->stats->nodes++;
+
+            double saved_largest = solver->largest[value->day];
+            var->assigned = i;
+            solver->order[depth] = u;
+            apply_value(solver, var, value, true);
+            solver->load[value->day] += var->hours;
+            if (var->hours > saved_largest) solver->largest[value->day] = var->hours;
+
+            int mark = solver->trail_len;
+            if (propagate(solver, var, value, depth) && search(solver, depth + 1)) return true;
+
+            undo_pruning(solver, mark);
+            solver->load[value->day] -= var->hours;
+            solver->largest[value->day] = saved_largest;
+            apply_value(solver, var, value, false);
+            var->assigned = -1;
+            solver->stats->backtracks++;
+            if (solver->stats->limit_hit) return false;
+        }
+    }
+    return false;
+}
+
+bool solve_meetings(MeetingScheduler *scheduler, const Meeting *meetings, int count,
+                    long max_nodes, SolverStats *stats) {
+    memset(stats, 0, sizeof(*stats));
+    if (count == 0) return true;
+    int week_count = scheduler->week_count;
+    int max_phases = 1;
+    for (int f = 0; f < FREQ_COUNT; f++) {
+        int phases = frequency_phases((Frequency)f, week_count);
+        if (phases > max_phases) max_phases = phases;
+    }
+    int max_values = MAX_DAYS * slot_count() * max_phases;
+
+    Solver solver;
+    memset(&solver, 0, sizeof(solver));
+    solver.scheduler = scheduler;
+    solver.var_count = count;
+    solver.cap = WEEKLY_CAP_HOURS * week_count;
+    solver.max_nodes = max_nodes;
+    solver.stats = stats;
+    solver.vars = calloc(count, sizeof(SolverVar));
+    solver.values = malloc((size_t)count * max_values * sizeof(SolverValue));
+    solver.order = malloc(count * sizeof(int));
+    if (!solver.vars || !solver.values || !solver.order) {
+        printf("Error: Out of memory\n");
+        free(solver.vars);
+        free(solver.values);
+        free(solver.order);
+        return false;
+    }
+    memcpy(solver.load, scheduler->meeting_hours, sizeof(solver.load));
+    match_person_days(&solver);
+
+    bool ok = true;
+    int value_count = 0;
+    for (int i = 0; i < count; i++) {
+        SolverVar *var = &solver.vars[i];
+        const Meeting *meeting = &meetings[i];
+        var->meeting = meeting;
+        var->fixed_day = meeting->fixed_day[0] ? find_day_index(meeting->fixed_day) : -1;
+        if (var->fixed_day >= scheduler->day_count) var->fixed_day = -1; // build_domain then finds no values
+        var->duration = meeting->duration;
+        var->assigned = -1;
+        var->first = value_count;
+        if ((unsigned)meeting->frequency >= FREQ_COUNT || !allowed_starts(meeting->duration)) {
+            printf("Error: Invalid meeting %s\n", meeting->name);
+            ok = false;
+            continue;
+        }
+        var->period = frequency_period(meeting->frequency);
+        var->occurrences = frequency_occurrences(meeting->frequency, week_count);
+        var->phases = frequency_phases(meeting->frequency, week_count);
+        var->hours = duration_hours(meeting->duration) * var->occurrences;
+        var->count = build_domain(&solver, var, solver.values + value_count);
+        var->alive = var->count;
+        value_count += var->count;
+        if (var->count == 0) {
+            printf("Error: No consistent slot for %s (%s)\n", meeting->name, FREQUENCIES[meeting->frequency]);
+            ok = false;
+        }
+    }
+
+    if (ok) {
+        solver.pruned_at = malloc((size_t)value_count * sizeof(int));
+        solver.trail = malloc((size_t)value_count * sizeof(int));
+        if (!solver.pruned_at || !solver.trail) {
+            printf("Error: Out of memory\n");
+            ok = false;
+        } else {
+            for (int i = 0; i < value_count; i++) solver.pruned_at[i] = -1;
+            ok = search(&solver, 0);
+            if (!ok) printf(stats->limit_hit ? "Error: Solver gave up after %ld nodes\n" :
+                                               "Error: No feasible assignment (%ld nodes)\n", stats->nodes);
+        }
+    }
+
+    if (ok) {
+        // The search left its placements in the occupancy grid; clear them and
+        // commit through place_meeting so the series are recorded. Holiday
+        // occurrences are always skipped: a shifted one could take a slot the
+        // search has given to another meeting.
+        for (int depth = 0; depth < count; depth++) {
+            SolverVar *var = &solver.vars[solver.order[depth]];
+            apply_value(&solver, var, &solver.values[var->assigned], false);
+        }
+        HolidayPolicy policy = scheduler->holiday_policy;
+        scheduler->holiday_policy = HOLIDAY_SKIP;
+        int first_series = scheduler->series.count;
+        for (int depth = 0; depth < count && ok; depth++) {
+            SolverVar *var = &solver.vars[solver.order[depth]];
+            const SolverValue *value = &solver.values[var->assigned];
+            ok = place_meeting(scheduler, var->meeting, value->day, value->start, value->phase, var->occurrences) >= 0;
+        }
+        if (!ok) {
+            // All or nothing, like the search itself
+            printf("Error: Out of memory\n");
+            for (int i = first_series; i < scheduler->series.count; i++) remove_meeting(scheduler, i);
+        }
+        scheduler->holiday_policy = policy;
+    }
+
+    free(solver.pruned_at);
+    free(solver.trail);
+    free(solver.vars);
+    free(solver.values);
+    free(solver.order);
+    return ok;
+}
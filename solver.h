@@ -0,0 +1,26 @@
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include "scheduler_core.h"
+
+// Exact scheduling of a whole meeting list as a constraint problem.
+//
+// Each meeting takes one value (day, start, phase): it recurs every
+// frequency_period() weeks starting at week `phase`, which is also how the
+// ICS export describes it. Values must fit the free occupancy of every week
+// they touch and keep each day within the 2.5 h/week meeting cap that
+// add_meeting applies. The search assigns the meeting with the fewest
+// remaining values first, prunes neighbours' domains by forward checking
+// and backtracks on a wipe-out, so it finds an assignment whenever one
+// exists. Nothing is committed to the scheduler unless every meeting fits.
+// Occurrences that fall on a holiday are skipped, whatever the policy.
+typedef struct {
+    long nodes; // Values tried
+    long backtracks;
+    bool limit_hit; // Gave up after max_nodes
+} SolverStats;
+
+bool solve_meetings(MeetingScheduler *scheduler, const Meeting *meetings, int count,
+                    long max_nodes, SolverStats *stats);
+
+#endif
@@ -0,0 +1,69 @@
+#include <time.h>
+#include "stats.h"
+
+#ifdef SCHEDULER_STATS
+SchedulerStats scheduler_stats;
+
+static const char *PHASE_NAMES[PHASE_COUNT] = {
+    "open", "input", "place", "solve", "portfolio", "display", "export", "save"
+};
+static const char *REJECT_NAMES[REJECT_COUNT] = {"break", "late", "blocked", "daily_cap"};
+
+uint64_t stats_clock(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+void stats_phase_done(Phase phase, uint64_t started) {
+    STATS_ADD(phase_ns[phase], stats_clock() - started);
+    STATS_ADD(phase_calls[phase], 1);
+}
+
+// Starts of a duration_slots run that ends after the working day or after the last slot
+static SlotMask late_starts(int duration_slots) {
+    SlotMask late = 0;
+    int slots = slot_count();
+    for (int s = 0; s < slots; s++) {
+        if (s + duration_slots > slots || slot_minutes(s) + slots_to_minutes(duration_slots) > grid_config()->day_end) {
+            late |= (SlotMask)1 << s;
+        }
+    }
+    return late;
+}
+
+// Splits the candidate starts add_meeting did not find usable by reason
+void stats_candidates(SlotMask candidates, SlotMask usable, int duration_slots) {
+    candidates &= ~(SlotMask)0 >> (MAX_SLOTS - slot_count());
+    SlotMask allowed = allowed_starts(duration_slots);
+    SlotMask late = late_starts(duration_slots) & candidates;
+    STATS_ADD(candidates, __builtin_popcountll(candidates));
+    STATS_ADD(rejections[REJECT_LATE], __builtin_popcountll(late));
+    STATS_ADD(rejections[REJECT_BREAK], __builtin_popcountll(candidates & ~allowed & ~late));
+    STATS_ADD(rejections[REJECT_BLOCKED], __builtin_popcountll(candidates & allowed & ~usable));
+}
+
+void write_stats(FILE *fp) {
+    const SchedulerStats *s = &scheduler_stats;
+    fprintf(fp, "{\"enabled\": true, \"rule_checks\": {\"days\": %llu, \"empty\": %llu}, "
+                "\"add_meeting\": {\"calls\": %llu, \"placed\": %llu, \"candidates\": %llu, "
+                "\"candidates_per_call\": %.2f, \"rejections\": {",
+            (unsigned long long)s->rule_checks, (unsigned long long)s->rule_checks_empty,
+            (unsigned long long)s->add_meeting_calls, (unsigned long long)s->meetings_placed,
+            (unsigned long long)s->candidates,
+            s->add_meeting_calls ? (double)s->candidates / s->add_meeting_calls : 0.0);
+    for (int r = 0; r < REJECT_COUNT; r++) {
+        fprintf(fp, "%s\"%s\": %llu", r ? ", " : "", REJECT_NAMES[r], (unsigned long long)s->rejections[r]);
+    }
+    fprintf(fp, "}}, \"phases\": {");
+    for (int p = 0; p < PHASE_COUNT; p++) {
+        fprintf(fp, "%s\"%s\": {\"calls\": %llu, \"ms\": %.3f}", p ? ", " : "", PHASE_NAMES[p],
+                (unsigned long long)s->phase_calls[p], s->phase_ns[p] / 1e6);
+    }
+    fprintf(fp, "}}\n");
+}
+#else
+void write_stats(FILE *fp) {
+    fprintf(fp, "{\"enabled\": false}\n");
+}
+#endif
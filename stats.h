@@ -0,0 +1,67 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include "scheduler_core.h"
+
+// Optional hot-path instrumentation, compiled in with -DSCHEDULER_STATS
+// (`make STATS=1`). Without it every STATS_* and PHASE_* macro expands to
+// nothing and write_stats reports {"enabled": false}.
+//
+// Counters are process-wide and updated with relaxed atomics, so portfolio
+// workers add to the same totals; phase times are then summed over threads.
+// Phases nest: time in PHASE_PLACE is also part of whichever phase called
+// add_meeting.
+typedef enum {
+    PHASE_OPEN, // New calendar or snapshot load
+    PHASE_INPUT, // Reading a batch file, including greedy placement
+    PHASE_PLACE, // add_meeting and try_add_meeting
+    PHASE_SOLVE,
+    PHASE_PORTFOLIO,
+    PHASE_DISPLAY,
+    PHASE_EXPORT,
+    PHASE_SAVE, // Snapshot write
+    PHASE_COUNT
+} Phase;
+
+// Why add_meeting passed over a candidate start (or, for the cap, a whole day)
+typedef enum {
+    REJECT_BREAK, // The run would cross the lunch break
+    REJECT_LATE, // The run would end after the working day (17:00 by default)
+    REJECT_BLOCKED, // Busy in too many weeks
+    REJECT_DAILY_CAP, // Day already holds 2.5 h of meetings per week
+    REJECT_COUNT
+} RejectReason;
+
+typedef struct {
+    uint64_t rule_checks; // Days add_meeting tested every week of a rule on
+    uint64_t rule_checks_empty; // Those with no start free in every week
+    uint64_t add_meeting_calls;
+    uint64_t meetings_placed;
+    uint64_t candidates; // Starts evaluated by add_meeting, over all days tried
+    uint64_t rejections[REJECT_COUNT];
+    uint64_t phase_ns[PHASE_COUNT];
+    uint64_t phase_calls[PHASE_COUNT];
+} SchedulerStats;
+
+#ifdef SCHEDULER_STATS
+extern SchedulerStats scheduler_stats;
+uint64_t stats_clock(void);
+void stats_phase_done(Phase phase, uint64_t started);
+void stats_candidates(SlotMask candidates, SlotMask usable, int duration_slots);
+#define STATS_ADD(field, n) __atomic_fetch_add(&scheduler_stats.field, (uint64_t)(n), __ATOMIC_RELAXED)
+#define STATS_CANDIDATES(candidates, usable, duration_slots) stats_candidates(candidates, usable, duration_slots)
+#define PHASE_BEGIN(phase) uint64_t phase##_started = stats_clock()
+#define PHASE_END(phase) stats_phase_done(phase, phase##_started)
+#else
+#define STATS_ADD(field, n) ((void)0)
+#define STATS_CANDIDATES(candidates, usable, duration_slots) ((void)0)
+#define PHASE_BEGIN(phase) ((void)0)
+#define PHASE_END(phase) ((void)0)
+#endif
+
+// One JSON object with every counter and phase
+void write_stats(FILE *fp);
+
+#endif
@@ -0,0 +1,114 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "workload.h"
+
+static const char *TYPES[] = {"one-to-one", "management", "client update", "review"};
+#define TYPE_COUNT (int)(sizeof(TYPES) / sizeof(TYPES[0]))
+
+// splitmix64, the same generator as scheduler_random, reduced to [0, bound)
+static uint32_t next_random(uint64_t *state, uint32_t bound) {
+    uint64_t z = (*state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    z ^= z >> 31;
+    return (uint32_t)(((z >> 32) * bound) >> 32);
+}
+
+static bool chance(uint64_t *state, int percent) {
+    return (int)next_random(state, 100) < percent;
+}
+
+// Random start a meeting of duration_slots may use
+static int random_start(uint64_t *state, int duration_slots) {
+    SlotMask starts = allowed_starts(duration_slots);
+    if (!starts) return 0;
+    int pick = next_random(state, __builtin_popcountll(starts));
+    while (pick-- > 0) starts &= starts - 1;
+    return __builtin_ctzll(starts);
+}
+
+// One of the standard DURATIONS in slots of the grid; one slot if the grid cannot hold it
+static int random_duration(uint64_t *state) {
+    int slots = minutes_to_slots(DURATIONS[next_random(state, 3)]);
+    return slots > 0 ? slots : 1;
+}
+
+void workload_defaults(WorkloadOptions *options) {
+    *options = (WorkloadOptions){
+        .seed = 1,
+        .meetings = 100,
+        .reservations = 10,
+        .frequency_mix = {4, 3, 1, 2},
+        .fixed_day_percent = 20,
+        .fixed_time_percent = 10,
+        .preferred_percent = 50,
+        .max_preferred = 4,
+    };
+}
+
+bool generate_workload(Workload *workload, const WorkloadOptions *options, int day_count) {
+    *workload = (Workload){0};
+    int mix_total = 0;
+    for (int f = 0; f < FREQ_COUNT; f++) mix_total += options->frequency_mix[f];
+    if (options->meetings < 0 || options->reservations < 0 || mix_total <= 0 ||
+        options->max_preferred < 1 || options->max_preferred > 8 || day_count < 1 || day_count > MAX_DAYS) {
+        printf("Error: Invalid workload options\n");
+        return false;
+    }
+    workload->meetings = calloc(options->meetings > 0 ? options->meetings : 1, sizeof(Meeting));
+    workload->reservations = calloc(options->reservations > 0 ? options->reservations : 1, sizeof(Reservation));
+    if (!workload->meetings || !workload->reservations) {
+        printf("Error: Out of memory\n");
+        free_workload(workload);
+        return false;
+    }
+
+    uint64_t state = options->seed;
+    for (int i = 0; i < options->meetings; i++) {
+        Meeting *m = &workload->meetings[workload->count++];
+        const char *type = TYPES[next_random(&state, TYPE_COUNT)];
+        snprintf(m->name, MAX_STR, "%s %d", type, i + 1);
+        snprintf(m->type, MAX_STR, "%s", type);
+        m->duration = random_duration(&state);
+        int pick = next_random(&state, mix_total);
+        int f = 0;
+        while (pick >= options->frequency_mix[f]) pick -= options->frequency_mix[f++];
+        m->frequency = f;
+        if (chance(&state, options->fixed_day_percent)) {
+            snprintf(m->fixed_day, MAX_STR, "%s", DAYS[next_random(&state, day_count)]);
+        }
+        if (chance(&state, options->fixed_time_percent)) {
+            snprintf(m->fixed_time, MAX_STR, "%s", TIME_SLOTS[random_start(&state, m->duration)]);
+        }
+        int preferred = 0;
+        if (chance(&state, options->preferred_percent)) {
+            int length = 1 + next_random(&state, options->max_preferred);
+            while (preferred < length) m->preferred_hours[preferred++] = random_start(&state, m->duration);
+        }
+        if (preferred < 8) m->preferred_hours[preferred] = -1;
+    }
+    for (int i = 0; i < options->reservations; i++) {
+        Reservation *r = &workload->reservations[workload->reservation_count++];
+        r->day = next_random(&state, day_count);
+        r->duration = random_duration(&state);
+        r->start_time = random_start(&state, r->duration);
+    }
+    return true;
+}
+
+void free_workload(Workload *workload) {
+    free(workload->meetings);
+    free(workload->reservations);
+    *workload = (Workload){0};
+}
+
+int apply_reservations(MeetingScheduler *scheduler, const Workload *workload) {
+    int applied = 0;
+    for (int i = 0; i < workload->reservation_count; i++) {
+        const Reservation *r = &workload->reservations[i];
+        // Reservations repeat every week, so week 0 shows any clash
+        if (r->day >= scheduler->day_count || !is_valid_slot(scheduler, 0, r->day, r->start_time, r->duration)) continue;
+        if (reserve_slot_index(scheduler, r->day, r->start_time, r->duration)) applied++;
+    }
+    return applied;
+}
@@ -0,0 +1,37 @@
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include "scheduler_core.h"
+
+// Seeded synthetic meeting sets for benchmarks.
+//
+// The same options and seed always produce the same meetings and
+// reservations, on any machine, so runs of different versions are
+// comparable. Percentages are of the generated meetings.
+typedef struct {
+    uint64_t seed;
+    int meetings;
+    int reservations; // Weekly reservations to attempt; clashing ones are skipped
+    int frequency_mix[FREQ_COUNT]; // Relative weights of each Frequency
+    int fixed_day_percent;
+    int fixed_time_percent;
+    int preferred_percent; // Meetings with a preferred-hours list
+    int max_preferred; // Longest preferred-hours list, 1..8
+} WorkloadOptions;
+
+typedef struct {
+    Meeting *meetings;
+    int count;
+    Reservation *reservations;
+    int reservation_count;
+} Workload;
+
+void workload_defaults(WorkloadOptions *options);
+// Fixed days are drawn from the first day_count days
+bool generate_workload(Workload *workload, const WorkloadOptions *options, int day_count);
+void free_workload(Workload *workload);
+
+// Applies the reservations that do not clash with earlier ones; returns how many
+int apply_reservations(MeetingScheduler *scheduler, const Workload *workload);
+
+#endif